@@ -0,0 +1,112 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <algorithm>
+#include "BitPlane.h"
+
+using namespace std;
+
+BitPlane::BitPlane(): numRow(0), numVector(0), numWordPerVector(0), firstVector(0) {}
+
+void BitPlane::Initialize(int _numRow, int _numVector) {
+	numRow = _numRow;
+	numVector = _numVector;
+	numWordPerVector = (numRow + 63) / 64;
+	words.assign((size_t)numWordPerVector * numVector, 0);
+}
+
+uint64_t BitPlane::GetWord(int vector, int row) const {
+	// 64 rows of one vector starting at row (rows past the end read as 0)
+	const uint64_t *w = &words[0] + (size_t)vector*numWordPerVector;
+	int idx = row >> 6;
+	int shift = row & 63;
+	uint64_t x = (idx < numWordPerVector)? w[idx] >> shift : 0;
+	if (shift && idx+1 < numWordPerVector) {
+		x |= w[idx+1] << (64-shift);
+	}
+	return x;
+}
+
+void BitPlane::CopyRows(const BitPlane &orginal, int positionRow, int numRowCopy, int targetRow, int positionVector) {
+	// copy rows [positionRow, positionRow+numRowCopy) of vectors positionVector.. of the original to targetRow of every vector in this plane, word by word
+	if (words.empty()) {
+		return;
+	}
+	for (int v=0; v<numVector; v++) {
+		uint64_t *w = &words[0] + (size_t)v*numWordPerVector;
+		for (int r=0; r<numRowCopy; r+=64) {
+			uint64_t x = orginal.GetWord(positionVector+v, positionRow+r);
+			int n = min(64, numRowCopy-r);
+			if (n < 64) {
+				x &= ((uint64_t)1 << n) - 1;
+			}
+			int idx = (targetRow+r) >> 6;
+			int shift = (targetRow+r) & 63;
+			w[idx] |= x << shift;
+			if (shift && idx+1 < numWordPerVector) {
+				w[idx+1] |= x >> (64-shift);
+			}
+		}
+	}
+}
+
+int BitPlane::CountActiveRow(int vector) const {
+	int count = 0;
+	const uint64_t *w = &words[0] + (size_t)vector*numWordPerVector;
+	for (int i=0; i<numWordPerVector; i++) {
+		count += __builtin_popcountll(w[i]);
+	}
+	return count;
+}
+
+// fraction of the input vectors that activate each row, in one pass over the set bits
+void BitPlane::RowDensity(vector<double> &density) const {
+	vector<int> count(numRow, 0);
+	for (int v=0; v<numVector; v++) {
+		const uint64_t *w = &words[0] + (size_t)v*numWordPerVector;
+		for (int i=0; i<numWordPerVector; i++) {
+			for (uint64_t x=w[i]; x; x&=x-1) {
+				count[(i<<6) + __builtin_ctzll(x)]++;
+			}
+		}
+	}
+	density.resize(numRow);
+	for (int r=0; r<numRow; r++) {
+		density[r] = numVector? (double) count[r]/numVector : 0;
+	}
+}
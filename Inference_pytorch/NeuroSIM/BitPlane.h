@@ -0,0 +1,78 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef BITPLANE_H_
+#define BITPLANE_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Input activation bits packed 64 rows per word, stored vector by vector so that
+   all rows seen by one input vector are contiguous (bit r of vector v is
+   bit r%64 of words[v*numWordPerVector + r/64], padding bits are always 0) */
+class BitPlane {
+public:
+	BitPlane();
+	
+	/* Functions */
+	void Initialize(int _numRow, int _numVector);
+	void CopyRows(const BitPlane &orginal, int positionRow, int numRowCopy, int targetRow, int positionVector=0);
+	int CountActiveRow(int vector) const;
+	void RowDensity(vector<double> &density) const;
+	
+	bool GetBit(int row, int vector) const {
+		return (words[vector*numWordPerVector + (row>>6)] >> (row&63)) & 1;
+	}
+	void SetBit(int row, int vector) {
+		words[vector*numWordPerVector + (row>>6)] |= (uint64_t)1 << (row&63);
+	}
+	
+	/* Properties */
+	int numRow;
+	int numVector;
+	int numWordPerVector;
+	int firstVector;	// position of vector 0 in the layer's input (identifies the reads of the Monte Carlo read noise)
+	vector<uint64_t> words;
+	
+private:
+	uint64_t GetWord(int vector, int row) const;
+};
+
+#endif /* BITPLANE_H_ */
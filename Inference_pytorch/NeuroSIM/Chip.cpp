@@ -54,6 +54,7 @@
 #include "constant.h"
 #include "formula.h"
 #include "Param.h"
+#include "TraceFile.h"
 #include "Chip.h"
 
 using namespace std;
@@ -67,6 +68,52 @@ AdderTree *Gaccumulation;
 Sigmoid *Gsigmoid;
 BitShifter *GreLu;
 MaxPooling *maxPool;
+#pragma omp threadprivate(globalBuffer, GhTree, Gaccumulation, Gsigmoid, GreLu, maxPool)
+
+ChipContext ChipSaveContext() {
+	ChipContext context;
+	context.globalBuffer = globalBuffer;
+	context.GhTree = GhTree;
+	context.Gaccumulation = Gaccumulation;
+	context.Gsigmoid = Gsigmoid;
+	context.GreLu = GreLu;
+	context.maxPool = maxPool;
+	context.tile = TileSaveContext();
+	return context;
+}
+
+void ChipLoadContext(const ChipContext &context) {
+	globalBuffer = context.globalBuffer;
+	GhTree = context.GhTree;
+	Gaccumulation = context.Gaccumulation;
+	Gsigmoid = context.Gsigmoid;
+	GreLu = context.GreLu;
+	maxPool = context.maxPool;
+	TileLoadContext(context.tile);
+}
+
+ChipContext ChipCloneContext(const ChipContext &context) {
+	ChipContext copy;
+	copy.globalBuffer = context.globalBuffer? new Buffer(*context.globalBuffer) : NULL;
+	copy.GhTree = context.GhTree? new HTree(*context.GhTree) : NULL;
+	copy.Gaccumulation = context.Gaccumulation? new AdderTree(*context.Gaccumulation) : NULL;
+	copy.Gsigmoid = context.Gsigmoid? new Sigmoid(*context.Gsigmoid) : NULL;
+	copy.GreLu = context.GreLu? new BitShifter(*context.GreLu) : NULL;
+	copy.maxPool = context.maxPool? new MaxPooling(*context.maxPool) : NULL;
+	copy.tile = TileCloneContext(context.tile);
+	return copy;
+}
+
+void ChipFreeContext(ChipContext &context) {
+	delete context.globalBuffer;
+	delete context.GhTree;
+	delete context.Gaccumulation;
+	delete context.Gsigmoid;
+	delete context.GreLu;
+	delete context.maxPool;
+	TileFreeContext(context.tile);
+	context = ChipContext();
+}
 
 
 vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, const vector<vector<double> > &netStructure,
@@ -140,156 +187,234 @@ vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tec
 }
 
 
-vector<vector<double> > ChipFloorPlan(bool findNumTile, bool findUtilization, bool findSpeedUp, const vector<vector<double> > &netStructure, const vector<int > &markNM, 
-					double maxPESizeNM, double maxTileSizeCM, double numPENM,
-					double *desiredNumTileNM, double *desiredPESizeNM, double *desiredNumTileCM, double *desiredTileSizeCM, double *desiredPESizeCM, int *numTileRow, int *numTileCol) {
+// sizes tried by the floorplan search, largest first: halving from maxSize (floorPlanSearch = 0, as NeuroSim always did)
+// or every multiple of the subArray size (floorPlanSearch = 1); PE sizes (tileSize > 0) must divide their tile size,
+// tile sizes (tileSize < 0) must be divisible into at least two PEs of two subArrays or more
+static vector<double> FloorPlanCandidates(double maxSize, double minSize, double tileSize) {
+	vector<double> candidates;
+	if (param->floorPlanSearch == 0) {
+		for (double thisSize = maxSize; thisSize >= minSize; thisSize/=2) {
+			candidates.push_back(thisSize);
+		}
+	} else {
+		for (double thisSize = floor(maxSize/param->numRowSubArray)*param->numRowSubArray; thisSize >= minSize; thisSize -= param->numRowSubArray) {
+			if ((tileSize > 0 && fmod(tileSize, thisSize) != 0) || (tileSize < 0 && FloorPlanCandidates(thisSize/2, 2*param->numRowSubArray, thisSize).empty())) {
+				continue;
+			}
+			candidates.push_back(thisSize);
+		}
+	}
+	return candidates;
+}
+
+// floorPlanSearch = 0: returns the index of the candidate of highest utilization above minUtilization (the first, i.e. largest,
+// on ties) and leaves its design in *best, -1 if none is above
+template <typename Design>
+static int FloorPlanSearch(const vector<double> &candidates, double minUtilization, Design design, vector<double> *best) {
+	int found = -1;
+	double maxUtilization = minUtilization;
+	for (int i=0; i<candidates.size(); i++) {
+		vector<double> thisDesign = design(candidates[i]);
+		if (thisDesign[2] > maxUtilization) {
+			maxUtilization = thisDesign[2];
+			found = i;
+			*best = thisDesign;
+		}
+	}
+	return found;
+}
+
+// duplication, # of tiles, utilization and speed-up of each layer for the tile and PE sizes of the plan
+static void FloorPlanLayers(FloorPlan *plan, const vector<vector<double> > &netStructure, const vector<int > &markNM, double numPENM) {
+	int numRowPerSynapse = param->numRowPerSynapse;
+	int numColPerSynapse = param->numColPerSynapse;
+	vector<vector<double> > peDup = PEDesign(false, plan->desiredPESizeCM, plan->desiredTileSizeCM, plan->desiredNumTileCM, markNM, netStructure, numRowPerSynapse, numColPerSynapse);
+	/*** SubArray Duplication ***/
+	vector<vector<double> > subArrayDup = SubArrayDup(plan->desiredPESizeCM, plan->desiredPESizeNM, markNM, netStructure, numRowPerSynapse, numColPerSynapse);
+	/*** Design SubArray ***/
+	plan->numTileEachLayer = OverallEachLayer(false, false, peDup, subArrayDup, plan->desiredTileSizeCM, plan->desiredPESizeNM, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
+	plan->utilizationEachLayer = OverallEachLayer(true, false, peDup, subArrayDup, plan->desiredTileSizeCM, plan->desiredPESizeNM, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
+	plan->speedUpEachLayer = OverallEachLayer(false, true, peDup, subArrayDup, plan->desiredTileSizeCM, plan->desiredPESizeNM, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
+}
+
+// score of a laid out plan, higher is better: memory utilization of the whole chip (as NeuroSimPrintFloorPlan reports it),
+// or with floorPlanMetric = 1 the # of tiles first and the utilization only on ties
+static void FloorPlanScore(const FloorPlan &plan, double *primary, double *secondary) {
+	double totalNumTile = 0;
+	double realMappedMemory = 0;
+	for (int i=0; i<plan.numTileEachLayer[0].size(); i++) {
+		double numTile = plan.numTileEachLayer[0][i]*plan.numTileEachLayer[1][i];
+		totalNumTile += numTile;
+		realMappedMemory += numTile*plan.utilizationEachLayer[i][0];
+	}
+	double utilization = realMappedMemory/totalNumTile;
+	if (param->floorPlanMetric == 0) {
+		*primary = utilization;
+		*secondary = 0;
+	} else {
+		*primary = -totalNumTile;
+		*secondary = utilization;
+	}
+}
+
+// floorPlanSearch = 1: every (novel mapped PE size, conventional tile size, conventional PE size) combination is laid out in full
+// and scored by floorPlanMetric, so the PE size is not picked for a tile size that was fixed on its own utilization;
+// the plans are laid out in parallel, the first (largest sizes) of the best score is kept
+static void FloorPlanJointSearch(FloorPlan *plan, const vector<vector<double> > &netStructure, const vector<int > &markNM, double maxPESizeNM, double maxTileSizeCM, double numPENM) {
+	vector<double> peSizesNM(1, 0);
+	if (param->novelMapping) {
+		peSizesNM = FloorPlanCandidates(maxPESizeNM, 2*param->numRowSubArray, 0);
+	}
+	vector<double> tileSizesCM = FloorPlanCandidates(maxTileSizeCM, 4*param->numRowSubArray, -1);
 	
+	vector<FloorPlan> plans;
+	for (int i=0; i<peSizesNM.size(); i++) {
+		FloorPlan thisPlan = *plan;
+		if (param->novelMapping) {
+			thisPlan.desiredPESizeNM = peSizesNM[i];
+			thisPlan.desiredNumTileNM = TileDesignNM(peSizesNM[i], markNM, netStructure, param->numRowPerSynapse, param->numColPerSynapse, numPENM)[0];
+		}
+		if (tileSizesCM.empty()) {   // no layer is conventionally mapped
+			plans.push_back(thisPlan);
+		}
+		for (int j=0; j<tileSizesCM.size(); j++) {
+			thisPlan.desiredTileSizeCM = tileSizesCM[j];
+			thisPlan.desiredNumTileCM = TileDesignCM(tileSizesCM[j], markNM, netStructure, param->numRowPerSynapse, param->numColPerSynapse)[0];
+			vector<double> peSizesCM = FloorPlanCandidates(tileSizesCM[j]/2, 2*param->numRowSubArray, tileSizesCM[j]);
+			for (int k=0; k<peSizesCM.size(); k++) {
+				thisPlan.desiredPESizeCM = peSizesCM[k];
+				plans.push_back(thisPlan);
+			}
+		}
+	}
 	
-	int numRowPerSynapse, numColPerSynapse;
-	numRowPerSynapse = param->numRowPerSynapse;
-	numColPerSynapse = param->numColPerSynapse;
+	vector<double> primary(plans.size()), secondary(plans.size());
+	#pragma omp parallel for schedule(dynamic)
+	for (int i=0; i<plans.size(); i++) {
+		FloorPlanLayers(&plans[i], netStructure, markNM, numPENM);
+		FloorPlanScore(plans[i], &primary[i], &secondary[i]);
+	}
+	int best = -1;
+	for (int i=0; i<plans.size(); i++) {
+		if (best < 0 || primary[i] > primary[best] || (primary[i] == primary[best] && secondary[i] > secondary[best])) {
+			best = i;
+		}
+	}
+	if (best >= 0) {
+		*plan = plans[best];
+	}
+}
+
+struct TileDesignCMSearch {
+	const vector<int> &markNM;
+	const vector<vector<double> > &netStructure;
+	vector<double> operator()(double tileSize) const {
+		return TileDesignCM(tileSize, markNM, netStructure, param->numRowPerSynapse, param->numColPerSynapse);
+	}
+};
+
+struct TileDesignNMSearch {
+	const vector<int> &markNM;
+	const vector<vector<double> > &netStructure;
+	double numPENM;
+	vector<double> operator()(double peSize) const {
+		return TileDesignNM(peSize, markNM, netStructure, param->numRowPerSynapse, param->numColPerSynapse, numPENM);
+	}
+};
+
+struct PEDesignSearch {
+	const vector<int> &markNM;
+	const vector<vector<double> > &netStructure;
+	double desiredTileSizeCM, desiredNumTileCM;
+	vector<double> operator()(double peSize) const {
+		// same layout as the tile designs: utilization at [2]
+		vector<vector<double> > design = PEDesign(true, peSize, desiredTileSizeCM, desiredNumTileCM, markNM, netStructure, param->numRowPerSynapse, param->numColPerSynapse);
+		vector<double> result(3, 0);
+		result[0] = design[0][0];
+		result[2] = design[1][0];
+		return result;
+	}
+};
+
+
+FloorPlan ChipFloorPlan(const vector<vector<double> > &netStructure, const vector<int > &markNM, double maxPESizeNM, double maxTileSizeCM, double numPENM) {
 	
 	double maxUtilizationNM = 0;
 	double maxUtilizationCM = 0;
 	
-	vector<vector<double> > peDup;
-	vector<vector<double> > subArrayDup;
-	vector<vector<double> > numTileEachLayer;
-	vector<vector<double> > utilizationEachLayer;
-	vector<vector<double> > speedUpEachLayer;
+	FloorPlan plan;
+	plan.desiredNumTileNM = 0;
+	plan.desiredPESizeNM = 0;
+	plan.desiredNumTileCM = 0;
+	plan.desiredTileSizeCM = 0;
+	plan.desiredPESizeCM = 0;
+	plan.numTileRow = 0;
+	plan.numTileCol = 0;
 	
-	*desiredNumTileNM = 0;
-	*desiredPESizeNM = 0;
-	*desiredNumTileCM = 0;
-	*desiredTileSizeCM = 0;
-	*desiredPESizeCM = 0;
-	*numTileRow = 0;
-	*numTileCol = 0;
-
-	if (param->novelMapping) {   // Novel Mapping
-		if (maxPESizeNM < 2*param->numRowSubArray) {
-			cout << "ERROR: SubArray Size is too large, which break the chip hierarchey, please decrease the SubArray size! " << endl;
-		}else{
-		
-			/*** Tile Design ***/
-			for (double thisPESize = maxPESizeNM; thisPESize>= 2*param->numRowSubArray; thisPESize/=2) {
-				// for layers use novel mapping
-				double thisUtilization = 0;
-				vector<double> thisDesign;
-				thisDesign = TileDesignNM(thisPESize, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
-				thisUtilization = thisDesign[2];
-				if (thisUtilization > maxUtilizationNM) {
-					maxUtilizationNM = thisUtilization;
-					*desiredPESizeNM = thisPESize;
-					*desiredNumTileNM = thisDesign[0];
-				}
-			}
-			for (double thisTileSize = maxTileSizeCM; thisTileSize >= 4*param->numRowSubArray; thisTileSize/=2) {
-				// for layers use conventional mapping
-				double thisUtilization = 0;
-				vector<double> thisDesign;
-				thisDesign = TileDesignCM(thisTileSize, markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-				thisUtilization = thisDesign[2];
-				if (thisUtilization > maxUtilizationCM) {
-					maxUtilizationCM = thisUtilization;
-					*desiredTileSizeCM = thisTileSize;
-					*desiredNumTileCM = thisDesign[0];
-				}
-			}
-			/*** PE Design ***/
-			for (double thisPESize = (*desiredTileSizeCM)/2; thisPESize >= 2*param->numRowSubArray; thisPESize/=2) {
-				// define PE Size for layers use conventional mapping
-				double thisUtilization = 0;
-				vector<vector<double> > thisDesign;
-				thisDesign = PEDesign(true, thisPESize, (*desiredTileSizeCM), (*desiredNumTileCM), markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-				thisUtilization = thisDesign[1][0];
-				if (thisUtilization > maxUtilizationCM) {
-					maxUtilizationCM = thisUtilization;
-					*desiredPESizeCM = thisPESize;
-				}
+	TileDesignCMSearch tileDesignCM = {markNM, netStructure};
+	TileDesignNMSearch tileDesignNM = {markNM, netStructure, numPENM};
+	vector<double> candidates, thisDesign;
+	int found;
+
+	if (param->novelMapping && maxPESizeNM < 2*param->numRowSubArray) {
+		cout << "ERROR: SubArray Size is too large, which break the chip hierarchey, please decrease the SubArray size! " << endl;
+	} else if (!param->novelMapping && maxTileSizeCM < 4*param->numRowSubArray) {
+		cout << "ERROR: SubArray Size is too large, which break the chip hierarchey, please decrease the SubArray size! " << endl;
+	} else if (param->floorPlanSearch == 1) {
+		FloorPlanJointSearch(&plan, netStructure, markNM, maxPESizeNM, maxTileSizeCM, numPENM);
+	} else {
+		/*** Tile Design ***/
+		if (param->novelMapping) {   // Novel Mapping
+			// for layers use novel mapping
+			candidates = FloorPlanCandidates(maxPESizeNM, 2*param->numRowSubArray, 0);
+			found = FloorPlanSearch(candidates, maxUtilizationNM, tileDesignNM, &thisDesign);
+			if (found >= 0) {
+				maxUtilizationNM = thisDesign[2];
+				plan.desiredPESizeNM = candidates[found];
+				plan.desiredNumTileNM = thisDesign[0];
 			}
-			peDup = PEDesign(false, (*desiredPESizeCM), (*desiredTileSizeCM), (*desiredNumTileCM), markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-			/*** SubArray Duplication ***/
-			subArrayDup = SubArrayDup((*desiredPESizeCM), (*desiredPESizeNM), markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-			/*** Design SubArray ***/
-			numTileEachLayer = OverallEachLayer(false, false, peDup, subArrayDup, (*desiredTileSizeCM), (*desiredPESizeNM), markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
-			utilizationEachLayer = OverallEachLayer(true, false, peDup, subArrayDup, (*desiredTileSizeCM), (*desiredPESizeNM), markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
-			speedUpEachLayer = OverallEachLayer(false, true, peDup, subArrayDup, (*desiredTileSizeCM), (*desiredPESizeNM), markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
 		}
-	} else {   // all Conventional Mapping
-		if (maxTileSizeCM < 4*param->numRowSubArray) {
-			cout << "ERROR: SubArray Size is too large, which break the chip hierarchey, please decrease the SubArray size! " << endl;
-		} else {
-			/*** Tile Design ***/
-			for (double thisTileSize = maxTileSizeCM; thisTileSize >= 4*param->numRowSubArray; thisTileSize/=2) {
-				// for layers use conventional mapping
-				double thisUtilization = 0;
-				vector<double> thisDesign;
-				thisDesign = TileDesignCM(thisTileSize, markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-				thisUtilization = thisDesign[2];
-				if (thisUtilization > maxUtilizationCM) {
-					maxUtilizationCM = thisUtilization;
-					*desiredTileSizeCM = thisTileSize;
-					*desiredNumTileCM = thisDesign[0];
-				}
-			}
-
-			/*** PE Design ***/
-			for (double thisPESize = (*desiredTileSizeCM)/2; thisPESize >= 2*param->numRowSubArray; thisPESize/=2) {
-				// define PE Size for layers use conventional mapping
-				double thisUtilization = 0;
-				vector<vector<double> > thisDesign;
-				thisDesign = PEDesign(true, thisPESize, (*desiredTileSizeCM), (*desiredNumTileCM), markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-				thisUtilization = thisDesign[1][0];
-				if (thisUtilization > maxUtilizationCM) {
-					maxUtilizationCM = thisUtilization;
-					*desiredPESizeCM = thisPESize;
-				}
-			}
-			peDup = PEDesign(false, (*desiredPESizeCM), (*desiredTileSizeCM), (*desiredNumTileCM), markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-			/*** SubArray Duplication ***/
-			subArrayDup = SubArrayDup((*desiredPESizeCM), 0, markNM, netStructure, numRowPerSynapse, numColPerSynapse);
-			/*** Design SubArray ***/
-			numTileEachLayer = OverallEachLayer(false, false, peDup, subArrayDup, (*desiredTileSizeCM), 0, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
-			utilizationEachLayer = OverallEachLayer(true, false, peDup, subArrayDup, (*desiredTileSizeCM), 0, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
-			speedUpEachLayer = OverallEachLayer(false, true, peDup, subArrayDup, (*desiredTileSizeCM), 0, markNM, netStructure, numRowPerSynapse, numColPerSynapse, numPENM);
+		// for layers use conventional mapping
+		candidates = FloorPlanCandidates(maxTileSizeCM, 4*param->numRowSubArray, -1);
+		found = FloorPlanSearch(candidates, maxUtilizationCM, tileDesignCM, &thisDesign);
+		if (found >= 0) {
+			maxUtilizationCM = thisDesign[2];
+			plan.desiredTileSizeCM = candidates[found];
+			plan.desiredNumTileCM = thisDesign[0];
 		}
+		/*** PE Design ***/
+		// define PE Size for layers use conventional mapping: the PE size of highest utilization, compared with the
+		// other PE sizes only (not with the tile utilization, which no PE size beats when no layer can be duplicated)
+		PEDesignSearch peDesign = {markNM, netStructure, plan.desiredTileSizeCM, plan.desiredNumTileCM};
+		candidates = FloorPlanCandidates(plan.desiredTileSizeCM/2, 2*param->numRowSubArray, plan.desiredTileSizeCM);
+		found = FloorPlanSearch(candidates, 0, peDesign, &thisDesign);
+		if (found >= 0) {
+			maxUtilizationCM = thisDesign[2];
+			plan.desiredPESizeCM = candidates[found];
+		}
+		FloorPlanLayers(&plan, netStructure, markNM, numPENM);
 	}
 
-	*numTileRow = ceil((double)sqrt((double)(*desiredNumTileCM)+(double)(*desiredNumTileNM)));
-	*numTileCol = ceil((double)((*desiredNumTileCM)+(*desiredNumTileNM))/(double)(*numTileRow));
+	plan.numTileRow = ceil((double)sqrt((double)plan.desiredNumTileCM+(double)plan.desiredNumTileNM));
+	plan.numTileCol = ceil((double)(plan.desiredNumTileCM+plan.desiredNumTileNM)/(double)plan.numTileRow);
 	
-	vector<vector<double> > tileLocaEachLayer;
 	vector<double> tileLocaEachLayerRow;
 	vector<double> tileLocaEachLayerCol;
-	double thisTileTotal;
+	double thisTileTotal = 0;
 	for (int i=0; i<netStructure.size(); i++) {
 		if (i==0) {
 			tileLocaEachLayerRow.push_back(0);
 			tileLocaEachLayerCol.push_back(0);
 		} else {
-			thisTileTotal += numTileEachLayer[0][i]*numTileEachLayer[1][i];
-			tileLocaEachLayerRow.push_back((int)thisTileTotal/(*numTileRow));
-			tileLocaEachLayerCol.push_back((int)thisTileTotal%(*numTileRow)-1);
+			thisTileTotal += plan.numTileEachLayer[0][i]*plan.numTileEachLayer[1][i];
+			tileLocaEachLayerRow.push_back((int)thisTileTotal/plan.numTileRow);
+			tileLocaEachLayerCol.push_back((int)thisTileTotal%plan.numTileRow-1);
 		}
 	}
-	tileLocaEachLayer.push_back(tileLocaEachLayerRow);
-	tileLocaEachLayer.push_back(tileLocaEachLayerCol);
-
-	if (findNumTile) {
-		return numTileEachLayer;
-	} else if (findUtilization) {
-		return utilizationEachLayer;
-	} else if (findSpeedUp) {
-		return speedUpEachLayer;
-	} else {
-		return tileLocaEachLayer;
-	}
-	peDup.clear();
-	subArrayDup.clear();
-	numTileEachLayer.clear();
-	utilizationEachLayer.clear();
-	speedUpEachLayer.clear();
+	plan.tileLocaEachLayer.push_back(tileLocaEachLayerRow);
+	plan.tileLocaEachLayer.push_back(tileLocaEachLayerCol);
+	
+	return plan;
 }
 
 
@@ -481,12 +606,13 @@ vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tec
 }
 
 
-double ChipCalculatePerformance(MemCell& cell, int layerNumber, const string &newweightfile, const string &oldweightfile, const string &inputfile, bool followedByMaxPool, 
+void ChipCalculatePerformance(MemCell& cell, int layerNumber, const WeightMatrix &newMemory, const BitPlane &inputVector, bool followedByMaxPool, 
 							const vector<vector<double> > &netStructure, const vector<int> &markNM, const vector<vector<double> > &numTileEachLayer, const vector<vector<double> > &utilizationEachLayer, 
 							const vector<vector<double> > &speedUpEachLayer, const vector<vector<double> > &tileLocaEachLayer, double numPENM, double desiredPESizeNM, double desiredTileSizeCM, 
 							double desiredPESizeCM, double CMTileheight, double CMTilewidth, double NMTileheight, double NMTilewidth,
 							double *readLatency, double *readDynamicEnergy, double *leakage, double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy, 
-							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther) {
+							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther,
+							MonteCarloStream *variation, SamplingStatistics *sampling) {
 	
 	
 	int numRowPerSynapse, numColPerSynapse;
@@ -498,12 +624,9 @@ double ChipCalculatePerformance(MemCell& cell, int layerNumber, const string &ne
 	// get weight matrix file Size
 	int weightMatrixRow = netStructure[l][2]*netStructure[l][3]*netStructure[l][4]*numRowPerSynapse;
 	int weightMatrixCol = netStructure[l][5]*numColPerSynapse;
-	
-	// load in whole file 
-	vector<vector<double> > inputVector;
-	inputVector = LoadInInputData(inputfile); 
-	vector<vector<double> > newMemory;
-	newMemory = LoadInWeightData(newweightfile, numRowPerSynapse, numColPerSynapse, param->maxConductance, param->minConductance);
+	// the devices of a Monte Carlo trial (variation == NULL: nominal), the sampling accuracy of this layer is gathered in sampling
+	MatrixView weightView = newMemory.View();
+	EvaluationState evaluation = {variation, sampling, 0};
 	
 	*readLatency = 0;
 	*readDynamicEnergy = 0;
@@ -522,38 +645,61 @@ double ChipCalculatePerformance(MemCell& cell, int layerNumber, const string &ne
 	
 	double tileLeakage = 0;
 	
+	// the tiles of this layer are evaluated as tasks, each one on a private copy of the tile circuit modules;
+	// the per-tile results are reduced afterwards in (row, column) order so the totals do not depend on the schedule
+	int numTileRow = numTileEachLayer[0][l];
+	int numTileCol = numTileEachLayer[1][l];
+	vector<vector<double> > tilePerformance(numTileRow*numTileCol, vector<double>(13, 0));
+	TileContext tilePrototype = TileSaveContext();
+	
 	if (markNM[l] == 0) {   // conventional mapping
+		#pragma omp taskloop default(shared) grainsize(1)
+		for (int t=0; t<numTileRow*numTileCol; t++) {
+			int i = t/numTileCol;   // tile row
+			int j = t%numTileCol;   // tile column
+			
+			TileContext saved = TileSaveContext();
+			TileContext context = TileCloneContext(tilePrototype);
+			TileLoadContext(context);
+			vector<double> &p = tilePerformance[t];
+			
+			int numRowMatrix = min(desiredTileSizeCM, weightMatrixRow-i*desiredTileSizeCM);
+			int numColMatrix = min(desiredTileSizeCM, weightMatrixCol-j*desiredTileSizeCM);
+			
+			// assign weight and input to specific tile
+			MatrixView tileMemory;
+			tileMemory = weightView.Block(i*desiredTileSizeCM, j*desiredTileSizeCM, numRowMatrix, numColMatrix);
+			
+			BitPlane tileInput;
+			tileInput = CopyInput(inputVector, i*desiredTileSizeCM, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, numRowMatrix);
+			
+			TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], ceil((double)desiredTileSizeCM/(double)desiredPESizeCM), desiredPESizeCM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
+								numRowMatrix, numColMatrix, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, cell, &p[0], &p[1], &p[2],
+								&p[3], &p[4], &p[5], &p[6], 
+								&p[7], &p[8], &p[9], &p[10], &p[11], &p[12], evaluation);
+			
+			TileLoadContext(saved);
+			TileFreeContext(context);
+		}
+		
 		for (int i=0; i<numTileEachLayer[0][l]; i++) {       // # of tiles in row
 			for (int j=0; j<numTileEachLayer[1][l]; j++) {   // # of tiles in Column
 				
-				double tileReadLatency = 0;
-				double tileReadDynamicEnergy = 0;
-				double tilebufferLatency = 0;
-				double tilebufferDynamicEnergy = 0;
-				double tileicLatency = 0;
-				double tileicDynamicEnergy = 0;
-				double tileLatencyADC = 0;
-				double tileLatencyAccum = 0;
-				double tileLatencyOther = 0;
-				double tileEnergyADC = 0;
-				double tileEnergyAccum = 0;
-				double tileEnergyOther = 0;
-
-				int numRowMatrix = min(desiredTileSizeCM, weightMatrixRow-i*desiredTileSizeCM);
-				int numColMatrix = min(desiredTileSizeCM, weightMatrixCol-j*desiredTileSizeCM);
-				
-				// assign weight and input to specific tile
-				vector<vector<double> > tileMemory;
-				tileMemory = CopyArray(newMemory, i*desiredTileSizeCM, j*desiredTileSizeCM, numRowMatrix, numColMatrix);
+				vector<double> &p = tilePerformance[i*numTileCol+j];
+				double tileReadLatency = p[0];
+				double tileReadDynamicEnergy = p[1];
+				double tilebufferLatency = p[3];
+				double tilebufferDynamicEnergy = p[4];
+				double tileicLatency = p[5];
+				double tileicDynamicEnergy = p[6];
+				double tileLatencyADC = p[7];
+				double tileLatencyAccum = p[8];
+				double tileLatencyOther = p[9];
+				double tileEnergyADC = p[10];
+				double tileEnergyAccum = p[11];
+				double tileEnergyOther = p[12];
+				tileLeakage = p[2];
 				
-				vector<vector<double> > tileInput;
-				tileInput = CopyInput(inputVector, i*desiredTileSizeCM, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, numRowMatrix);
-				
-				TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], ceil((double)desiredTileSizeCM/(double)desiredPESizeCM), desiredPESizeCM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
-									numRowMatrix, numColMatrix, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, cell, &tileReadLatency, &tileReadDynamicEnergy, &tileLeakage,
-									&tilebufferLatency, &tilebufferDynamicEnergy, &tileicLatency, &tileicDynamicEnergy, 
-									&tileLatencyADC, &tileLatencyAccum, &tileLatencyOther, &tileEnergyADC, &tileEnergyAccum, &tileEnergyOther);
-
 				*readLatency = max(tileReadLatency, (*readLatency));
 				*readDynamicEnergy += tileReadDynamicEnergy;
 				*bufferLatency = max(tilebufferLatency, (*bufferLatency));
@@ -629,39 +775,54 @@ double ChipCalculatePerformance(MemCell& cell, int layerNumber, const string &ne
 		*coreEnergyOther += globalBuffer->readDynamicEnergy + globalBuffer->writeDynamicEnergy + GhTree->readDynamicEnergy;
 		
 	} else {   // novel Mapping
+		#pragma omp taskloop default(shared) grainsize(1)
+		for (int t=0; t<numTileRow*numTileCol; t++) {
+			int i = t/numTileCol;   // tile row
+			int j = t%numTileCol;   // tile column
+			
+			TileContext saved = TileSaveContext();
+			TileContext context = TileCloneContext(tilePrototype);
+			TileLoadContext(context);
+			vector<double> &p = tilePerformance[t];
+			
+			int numRowMatrix = netStructure[l][2]*netStructure[l][3]*netStructure[l][4]*numRowPerSynapse/numTileEachLayer[0][l];
+			int numColMatrix = netStructure[l][5]*numRowPerSynapse/numTileEachLayer[1][l];
+			
+			// assign weight and input to specific tile
+			MatrixView tileMemory;
+			tileMemory = weightView.Reshape(i*desiredPESizeNM, j*desiredPESizeNM, (int) netStructure[l][2]*numRowPerSynapse/numTileEachLayer[0][l], 
+								(int) netStructure[l][5]*numRowPerSynapse/numTileEachLayer[1][l], numPENM, (int) netStructure[l][2]*numRowPerSynapse);
+
+			BitPlane tileInput;
+			tileInput = ReshapeInput(inputVector, i*desiredPESizeNM, (int) (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, 
+								(int) netStructure[l][2]*numRowPerSynapse/numTileEachLayer[0][l], numPENM, (int) netStructure[l][2]*numRowPerSynapse);
+			
+			TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], numPENM, desiredPESizeNM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
+								numRowMatrix, numColMatrix, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, cell, 
+								&p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6],
+								&p[7], &p[8], &p[9], &p[10], &p[11], &p[12], evaluation);
+			
+			TileLoadContext(saved);
+			TileFreeContext(context);
+		}
+		
 		for (int i=0; i<numTileEachLayer[0][l]; i++) {       // # of tiles in row
 			for (int j=0; j<numTileEachLayer[1][l]; j++) {   // # of tiles in Column
 				
-				double tileReadLatency = 0;
-				double tileReadDynamicEnergy = 0;
-				double tilebufferLatency = 0;
-				double tilebufferDynamicEnergy = 0;
-				double tileicLatency = 0;
-				double tileicDynamicEnergy = 0;
-				double tileLatencyADC = 0;
-				double tileLatencyAccum = 0;
-				double tileLatencyOther = 0;
-				double tileEnergyADC = 0;
-				double tileEnergyAccum = 0;
-				double tileEnergyOther = 0;
-
-				int numRowMatrix = netStructure[l][2]*netStructure[l][3]*netStructure[l][4]*numRowPerSynapse/numTileEachLayer[0][l];
-				int numColMatrix = netStructure[l][5]*numRowPerSynapse/numTileEachLayer[1][l];
-				
-				// assign weight and input to specific tile
-				vector<vector<double> > tileMemory;
-				tileMemory = ReshapeArray(newMemory, i*desiredPESizeNM, j*desiredPESizeNM, (int) netStructure[l][2]*numRowPerSynapse/numTileEachLayer[0][l], 
-									(int) netStructure[l][5]*numRowPerSynapse/numTileEachLayer[1][l], numPENM, (int) netStructure[l][2]*numRowPerSynapse);
-
-				vector<vector<double> > tileInput;
-				tileInput = ReshapeInput(inputVector, i*desiredPESizeNM, (int) (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, 
-									(int) netStructure[l][2]*numRowPerSynapse/numTileEachLayer[0][l], numPENM, (int) netStructure[l][2]*numRowPerSynapse);
-				
-				TileCalculatePerformance(tileMemory, tileMemory, tileInput, markNM[l], numPENM, desiredPESizeNM, speedUpEachLayer[0][l], speedUpEachLayer[1][l],
-									numRowMatrix, numColMatrix, (netStructure[l][0]-netStructure[l][3]+1)*(netStructure[l][1]-netStructure[l][4]+1)*param->numBitInput, cell, 
-									&tileReadLatency, &tileReadDynamicEnergy, &tileLeakage, &tilebufferLatency, &tilebufferDynamicEnergy, &tileicLatency, &tileicDynamicEnergy,
-									&tileLatencyADC, &tileLatencyAccum, &tileLatencyOther, &tileEnergyADC, &tileEnergyAccum, &tileEnergyOther);
-				
+				vector<double> &p = tilePerformance[i*numTileCol+j];
+				double tileReadLatency = p[0];
+				double tileReadDynamicEnergy = p[1];
+				double tilebufferLatency = p[3];
+				double tilebufferDynamicEnergy = p[4];
+				double tileicLatency = p[5];
+				double tileicDynamicEnergy = p[6];
+				double tileLatencyADC = p[7];
+				double tileLatencyAccum = p[8];
+				double tileLatencyOther = p[9];
+				double tileEnergyADC = p[10];
+				double tileEnergyAccum = p[11];
+				double tileEnergyOther = p[12];
+				tileLeakage = p[2];
 				
 				*readLatency = max(tileReadLatency, (*readLatency));
 				*readDynamicEnergy += tileReadDynamicEnergy;
@@ -950,7 +1111,27 @@ vector<vector<double> > OverallEachLayer(bool utilization, bool speedUp, const v
 
 
 
-vector<vector<double> > LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance) {
+WeightMatrix LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance) {
+	
+	WeightMatrix weight;
+	
+	TraceFile trace;
+	if (trace.Open(weightfile)) {
+		// binary trace: read the mapped matrix directly
+		if (trace.header.bitWidth != 0 && trace.header.bitWidth != param->synapseBit) {
+			cerr << "Warning: " << weightfile << " was traced with " << trace.header.bitWidth << "-bit weights but synapseBit is " << param->synapseBit << endl;
+		}
+		weight.SetConductanceRange(param->cellBit, maxConductance, minConductance);
+		weight.numRow = trace.header.numRow;
+		weight.numCol = trace.header.numCol*numColPerSynapse;
+		weight.data.reserve((size_t)weight.numRow*weight.numCol);
+		for (int row=0; row<trace.header.numRow; row++) {
+			for (int col=0; col<trace.header.numCol; col++) {
+				WeightToCellCode(trace.Value(row, col), numColPerSynapse, weight.data);
+			}
+		}
+		return weight;
+	}
 	
 	ifstream fileone(weightfile.c_str());                           
 	string lineone;
@@ -978,103 +1159,101 @@ vector<vector<double> > LoadInWeightData(const string &weightfile, int numRowPer
 	fileone.clear();
 	fileone.seekg(0, ios::beg);                   
 	
-	
-	double NormalizedMin = 0;
-	double NormalizedMax = pow(2, param->synapseBit)-1;
-	
-	double RealMax = 1;
-	double RealMin = -1;
-	
-	vector<vector<double> > weight;            
-	// load the data into a weight matrix ...
+	// load the data into a weight matrix, row after row in one contiguous block ...
+	weight.SetConductanceRange(param->cellBit, maxConductance, minConductance);
+	weight.numRow = ROW;
+	weight.numCol = COL*numColPerSynapse;
+	weight.data.reserve((size_t)weight.numRow*weight.numCol);
 	for (int row=0; row<ROW; row++) {	
-		vector<double> weightrow;
-		vector<double> weightrowb;
 		getline(fileone, lineone, '\n');              
 		istringstream iss;
 		iss.str(lineone);
-		for (int col=0; col<COL; col++) {       
-			while(getline(iss, valone, ',')){	
-				istringstream fs;
-				fs.str(valone);
-				double f=0;
-				fs >> f;	
-				//normalize weight to integer
-				double newdata = ((NormalizedMax-NormalizedMin)/(RealMax-RealMin)*(f-RealMax)+NormalizedMax);
-				if (newdata >= 0) {
-					newdata += 0.5;
-				}else {
-					newdata -= 0.5;
-				}
-				// map and expend the weight in memory array
-				int cellrange = pow(2, param->cellBit);
-				vector<double> synapsevector(numColPerSynapse);       
-				int value = newdata;                  
-				int remainder;   
-				for (int z=0; z<numColPerSynapse; z++) {   
-					remainder = ceil((double)(value%cellrange));
-					value = ceil((double)(value/cellrange));
-					synapsevector.insert(synapsevector.begin(), remainder);
-				}
-				for (int u=0; u<numColPerSynapse; u++) {
-					double cellvalue = synapsevector[u];
-					double conductance = cellvalue/(cellrange-1) * (maxConductance-minConductance) + minConductance;
-					weightrow.push_back(conductance);
-				}		
-			}			
+		int col = 0;
+		while(getline(iss, valone, ',') && col<COL){	
+			istringstream fs;
+			fs.str(valone);
+			double f=0;
+			fs >> f;	
+			WeightToCellCode(f, numColPerSynapse, weight.data);
+			col++;
 		}		
-		weight.push_back(weightrow);
-		weightrow.clear();
+		if (col == 0) {   // trailing empty line
+			weight.numRow = row;
+			break;
+		} else if (col < COL) {
+			cerr << "Error: row " << row << " of " << weightfile << " has " << col << " entries, expected " << COL << endl;
+			exit(-1);
+		}
 	}
 	fileone.close();
 	
 	return weight;
-	weight.clear();
 }
 
 
 
-vector<vector<double> > CopyArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol) {
+void WeightToCellCode(double f, int numColPerSynapse, vector<uint8_t> &weightrow) {
 	
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numCol; j++) {
-			copyRow.push_back(orginal[positionRow+i][positionCol+j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
+	double NormalizedMin = 0;
+	double NormalizedMax = ldexp(1.0, param->synapseBit)-1;
+	
+	double RealMax = 1;
+	double RealMin = -1;
+	
+	//normalize weight to integer
+	double newdata = ((NormalizedMax-NormalizedMin)/(RealMax-RealMin)*(f-RealMax)+NormalizedMax);
+	if (newdata >= 0) {
+		newdata += 0.5;
+	}else {
+		newdata -= 0.5;
 	}
+	int value = newdata;
+	value = max(0, min(value, (int) NormalizedMax));	// weights outside [-1, 1] saturate
 	
-	return copy;
-	copy.clear();
-} 
+	// map and expend the weight in memory array, one cell code per column, most significant cell first
+	int cellBit = param->cellBit;
+	int cellrange = 1 << cellBit;
+	size_t start = weightrow.size();
+	weightrow.resize(start + numColPerSynapse);
+	for (int z=numColPerSynapse-1; z>=0; z--) {
+		weightrow[start+z] = value & (cellrange-1);
+		value >>= cellBit;
+	}
+}
 
 
 
-vector<vector<double> > ReshapeArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol, int numPE, int weightMatrixRow) {
+BitPlane LoadInInputData(const string &inputfile) {
 	
-	vector<vector<double> > copy;
-
-	for (int k=0; k<numPE; k++) {
-		for (int i=0; i<numRow; i++) {
-			vector<double> copyRow;
-			for (int j=0; j<numCol; j++) {
-				copyRow.push_back(orginal[positionRow+k*weightMatrixRow+i][positionCol+j]);
+	BitPlane inputvector;
+	
+	TraceFile trace;
+	if (trace.Open(inputfile)) {
+		// binary trace: each row holds numBitInput bits per input vector, MSB first
+		if (trace.header.bitWidth != 0 && trace.header.bitWidth != param->numBitInput) {
+			cerr << "Error: " << inputfile << " was traced with " << trace.header.bitWidth << "-bit inputs but numBitInput is " << param->numBitInput << endl;
+			exit(-1);
+		}
+		if (trace.header.dtype == TRACE_INT8) {
+			// raw feature map: sliding windows and bit-planes are generated here
+			const TraceHeader &h = trace.header;
+			if (h.kernel == 0 || h.stride == 0 || h.numCol != (uint64_t)h.height*h.width || h.height + 2*h.padding < h.kernel || h.width + 2*h.padding < h.kernel) {
+				cerr << "Error: " << inputfile << " has an invalid feature map geometry!" << endl;
+				exit(-1);
+			}
+			return LoadInFeatureMap((const int8_t *)trace.data, h.numRow, h.height, h.width, h.kernel, h.stride, h.padding, param->numBitInput);
+		}
+		inputvector.Initialize(trace.header.numRow, trace.header.numCol);
+		for (int row=0; row<trace.header.numRow; row++) {
+			for (int col=0; col<trace.header.numCol; col++) {
+				if (trace.Value(row, col) != 0) {
+					inputvector.SetBit(row, col);
+				}
 			}
-			copy.push_back(copyRow);
-			copyRow.clear();
 		}
+		return inputvector;
 	}
 	
-	return copy;
-	copy.clear();
-} 
-
-
-
-vector<vector<double> > LoadInInputData(const string &inputfile) {
-	
 	ifstream infile(inputfile.c_str());     
 	string inputline;
 	string inputval;
@@ -1099,72 +1278,129 @@ vector<vector<double> > LoadInInputData(const string &inputfile) {
 	infile.clear();
 	infile.seekg(0, ios::beg);          
 	
-	vector<vector<double> > inputvector;              
-	// load the data into inputvector ...
+	// load the data into inputvector, one bit per activation ...
+	inputvector.Initialize(ROWin, COLin);
 	for (int row=0; row<ROWin; row++) {	
-		vector<double> inputvectorrow;
-		vector<double> inputvectorrowb;
 		getline(infile, inputline, '\n');             
 		istringstream iss;
 		iss.str(inputline);
-		for (int col=0; col<COLin; col++) {
-			while(getline(iss, inputval, ',')){	
-				istringstream fs;
-				fs.str(inputval);
-				double f=0;
-				fs >> f;	
-				inputvectorrow.push_back(f);
-			}			
+		int col = 0;
+		while(getline(iss, inputval, ',') && col<COLin){	
+			istringstream fs;
+			fs.str(inputval);
+			double f=0;
+			fs >> f;	
+			if (f != 0) {
+				inputvector.SetBit(row, col);
+			}
+			col++;
 		}		
-		inputvector.push_back(inputvectorrow);
-		inputvectorrow.clear();
 	}
 	// close the input file ...
 	infile.close();
 	
 	return inputvector;
-	inputvector.clear();
 }
 
 
 
+// same as LoadInWeightData/LoadInInputData, for matrices that are already in memory (row-major, layout of the trace files)
+WeightMatrix LoadInWeightArray(const double *data, int numRow, int numCol, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance) {
+	
+	WeightMatrix weight;
+	weight.SetConductanceRange(param->cellBit, maxConductance, minConductance);
+	weight.numRow = numRow;
+	weight.numCol = numCol*numColPerSynapse;
+	weight.data.reserve((size_t)weight.numRow*weight.numCol);
+	for (int row=0; row<numRow; row++) {
+		for (int col=0; col<numCol; col++) {
+			WeightToCellCode(data[(size_t)row*numCol+col], numColPerSynapse, weight.data);
+		}
+	}
+	return weight;
+}
+
 
-vector<vector<double> > CopyInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow) {
+
+BitPlane LoadInInputArray(const unsigned char *data, int numRow, int numCol) {
 	
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numInputVector; j++) {
-			copyRow.push_back(orginal[positionRow+i][j]);
+	BitPlane inputvector;
+	inputvector.Initialize(numRow, numCol);
+	for (int row=0; row<numRow; row++) {
+		for (int col=0; col<numCol; col++) {
+			if (data[(size_t)row*numCol+col] != 0) {
+				inputvector.SetBit(row, col);
+			}
 		}
-		copy.push_back(copyRow);
-		copyRow.clear();
 	}
+	return inputvector;
+}
+
+
+
+
+// im2col of a quantized feature map (numChannel x height x width codes, row-major) straight into the bit-planes:
+// row (c*kernel+ky)*kernel+kx and vector window*numBitInput+b hold bit b (MSB first) of the two's complement code under
+// that kernel position, the layout of stretch_input + activation_matrix_conv in the Python hooks (padding reads as 0)
+BitPlane LoadInFeatureMap(const int8_t *data, int numChannel, int height, int width, int kernel, int stride, int padding, int numBitInput) {
 	
-	return copy;
-	copy.clear();
+	int outHeight = (height + 2*padding - kernel)/stride + 1;
+	int outWidth = (width + 2*padding - kernel)/stride + 1;
+	int mask = (1 << numBitInput) - 1;
 	
-} 
+	BitPlane inputvector;
+	inputvector.Initialize(numChannel*kernel*kernel, outHeight*outWidth*numBitInput);
+	for (int oy=0; oy<outHeight; oy++) {
+		for (int ox=0; ox<outWidth; ox++) {
+			int col = (oy*outWidth + ox)*numBitInput;
+			for (int c=0; c<numChannel; c++) {
+				for (int ky=0; ky<kernel; ky++) {
+					int y = oy*stride - padding + ky;
+					if (y < 0 || y >= height) {
+						continue;
+					}
+					for (int kx=0; kx<kernel; kx++) {
+						int x = ox*stride - padding + kx;
+						if (x < 0 || x >= width) {
+							continue;
+						}
+						int code = data[((size_t)c*height + y)*width + x] & mask;
+						int row = (c*kernel + ky)*kernel + kx;
+						for (int b=0; code && b<numBitInput; b++) {
+							if ((code >> (numBitInput-1-b)) & 1) {
+								inputvector.SetBit(row, col+b);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return inputvector;
+}
 
 
 
-vector<vector<double> > ReshapeInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow, int numPE, int weightMatrixRow) {
+BitPlane CopyInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow) {
+	
+	BitPlane copy;
+	copy.Initialize(numRow, numInputVector);
+	copy.CopyRows(orginal, positionRow, numRow, 0);
 	
-	vector<vector<double> > copy;
+	return copy;
+} 
 
+
+
+BitPlane ReshapeInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow, int numPE, int weightMatrixRow) {
+	
+	BitPlane copy;
+	copy.Initialize(numPE*numRow, numInputVector);
 	for (int k=0; k<numPE; k++) {
-		for (int i=0; i<numRow; i++) {
-			vector<double> copyRow;
-			for (int j=0; j<numInputVector; j++) {
-				copyRow.push_back(orginal[positionRow+k*weightMatrixRow+i][j]);
-			}
-			copy.push_back(copyRow);
-			copyRow.clear();
-		}
+		copy.CopyRows(orginal, positionRow+k*weightMatrixRow, numRow, k*numRow);
 	}
 	
 	return copy;
-	copy.clear();
 } 
 
 
@@ -0,0 +1,386 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include "CrossbarSolver.h"
+#include "MonteCarlo.h"
+#include "Param.h"
+
+using namespace std;
+
+extern Param *param;
+
+static const double CG_TOLERANCE = 1e-13;	// residual relative to the right-hand side
+static const int CG_MAX_ITERATION = 1000;
+static const int NEWTON_MAX_ITERATION = 50;
+
+// variation: the devices of a Monte Carlo trial, NULL: nominal devices; replica: the copy of the duplicated subArray, see MonteCarloCellOf
+CrossbarSolver::CrossbarSolver(const MatrixView &weight, const MemCell &cell, const MonteCarloStream *variation, int replica): numRow(weight.numRow), numCol(weight.numCol) {
+	conductanceRow = 1/param->wireResistanceRow;
+	conductanceCol = 1/param->wireResistanceCol;
+	readVoltage = cell.readVoltage;
+	halfWriteVoltage = cell.writeVoltage/2;
+	nonlinearity = cell.nonlinearity;
+	bool access = cell.memCellType == Type::RRAM && cell.accessType == CMOS_access;
+	nonlinear = cell.nonlinearIV && !access && nonlinearity > 1;	// with an access transistor in series the cell stays linear, see MemCell::nonlinearIV
+	if (nonlinear && !(halfWriteVoltage > 0 && isfinite(pow(nonlinearity, 2*readVoltage/halfWriteVoltage)))) {
+		cerr << "Error: the nonlinear I-V of the IR drop solver needs a write voltage comparable to the read voltage!" << endl;
+		exit(-1);
+	}
+	
+	int numCell = numRow*numCol;
+	conductance.resize(numCell);
+	for (int i=0; i<numRow; i++) {
+		const uint8_t *w = weight.Row(i);
+		for (int j=0; j<numCol; j++) {
+			double g = weight.conductance[w[j]];
+			if (variation) {
+				g = MonteCarloCellConductance(*variation, MonteCarloCellOf(replica, w + j - weight.origin), g);
+			}
+			if (access) {
+				g = 1/(1/g + cell.resistanceAccess);
+			}
+			conductance[i*numCol+j] = g;
+		}
+	}
+	
+	// row line i: nodes i*numCol+j, column line j: nodes numCell+i*numCol+j, each one tridiagonal with the wire segments
+	// off the diagonal; the cells couple the two networks and are only kept on the diagonal
+	lower.resize(2*numCell);
+	inversePivot.resize(2*numCell);
+	for (int i=0; i<numRow; i++) {
+		double pivot = 0;
+		for (int j=0; j<numCol; j++) {
+			int p = i*numCol+j;
+			double diagonal = conductanceRow*(j+1 < numCol? 2 : 1) + conductance[p];
+			lower[p] = j? -conductanceRow/pivot : 0;
+			pivot = diagonal - lower[p]*(-conductanceRow);
+			inversePivot[p] = 1/pivot;
+		}
+	}
+	for (int j=0; j<numCol; j++) {
+		double pivot = 0;
+		for (int i=0; i<numRow; i++) {
+			int p = i*numCol+j;
+			double diagonal = conductanceCol*(i? 2 : 1) + conductance[p];
+			lower[numCell+p] = i? -conductanceCol/pivot : 0;
+			pivot = diagonal - lower[numCell+p]*(-conductanceCol);
+			inversePivot[numCell+p] = 1/pivot;
+		}
+	}
+}
+
+bool CrossbarSolver::Enabled(const MemCell &cell) {
+	return param->irDropSolver && cell.memCellType != Type::SRAM && param->wireResistanceRow > 0 && param->wireResistanceCol > 0;
+}
+
+// a parallel read of nonlinear cells does not superpose, every input vector needs its own solution
+// (same nonlinear test as the constructor, so that no solver is built only to ask)
+bool CrossbarSolver::PerVector(const MemCell &cell) {
+	bool access = cell.memCellType == Type::RRAM && cell.accessType == CMOS_access;
+	return Enabled(cell) && cell.nonlinearIV && !access && cell.nonlinearity > 1 && param->parallelRead;
+}
+
+// effective conductance of each cell: its current into the sense amp with only its row driven, over the read voltage;
+// returns false if a solve did not converge
+bool CrossbarSolver::TransferConductance(vector<double> &transfer) const {
+	bool converged = true;
+	transfer.resize(numRow*numCol);
+	vector<double> drive(numRow*BATCH), current(BATCH*numCol);
+	for (int first=0; first<numRow; first+=BATCH) {
+		int numBatch = min(BATCH, numRow-first);
+		fill(drive.begin(), drive.end(), 0);
+		for (int k=0; k<numBatch; k++) {
+			drive[(first+k)*numBatch + k] = readVoltage;
+		}
+		converged = Solve(&drive[0], numBatch, &current[0]) && converged;
+		for (int k=0; k<numBatch; k++) {
+			for (int j=0; j<numCol; j++) {
+				transfer[(first+k)*numCol+j] = current[k*numCol+j]/readVoltage;
+			}
+		}
+	}
+	return converged;
+}
+
+// column conductances (sense amp current over the read voltage) of the input vectors vector[0..numVector), numCol per vector;
+// returns false if a solve did not converge
+bool CrossbarSolver::ColumnConductance(const BitPlane &input, const int *vector, int numVector, double *columnG) const {
+	bool converged = true;
+	std::vector<double> drive(numRow*BATCH), current(BATCH*numCol);
+	for (int first=0; first<numVector; first+=BATCH) {
+		int numBatch = min(BATCH, numVector-first);
+		for (int i=0; i<numRow; i++) {
+			for (int k=0; k<numBatch; k++) {
+				drive[i*numBatch + k] = input.GetBit(i, vector[first+k])? readVoltage : 0;
+			}
+		}
+		converged = Solve(&drive[0], numBatch, &current[0]) && converged;
+		for (int k=0; k<numBatch*numCol; k++) {
+			columnG[(size_t) first*numCol + k] = current[k]/readVoltage;
+		}
+	}
+	return converged;
+}
+
+// cell current at voltage v across it: linear, or the current-ratio model of NonlinearResistance (v/NonlinearResistance(v)
+// scaled by (1-NL^(-v/(Vw/2)))/(1-NL^(-Vr/(Vw/2))) so that it is odd and vanishes at 0V), equal to the linear one at the read voltage
+double CrossbarSolver::CellCurrent(double g0, double v, double *slope) const {
+	if (!nonlinear) {
+		*slope = g0;
+		return g0*v;
+	}
+	double a = log(nonlinearity)/halfWriteVoltage;
+	double scale = g0*readVoltage/expm1(a*readVoltage);
+	*slope = scale*a*exp(a*fabs(v));
+	return (v < 0? -1 : 1) * scale*expm1(a*fabs(v));
+}
+
+// drive[i*numBatch+k]: voltage of the driver of row i in problem k, current[k*numCol+j]: current into sense amp j;
+// returns false if the conjugate gradient (linear cells) or the Newton iterations (nonlinear cells) did not converge
+bool CrossbarSolver::Solve(const double *drive, int numBatch, double *current) const {
+	bool converged;
+	int numCell = numRow*numCol;
+	size_t n = (size_t) 2*numCell*numBatch;
+	vector<double> b(n, 0), x(n, 0);
+	for (int i=0; i<numRow; i++) {
+		for (int k=0; k<numBatch; k++) {
+			b[(size_t) i*numCol*numBatch + k] = conductanceRow*drive[i*numBatch+k];
+		}
+	}
+	
+	if (!nonlinear) {
+		converged = ConjugateGradient(&b[0], &x[0], numBatch, &conductance[0], 0);
+	} else {
+		// Newton: J s = b - A x - I(x), J = wires + slopes of the cells, steps limited to Vw/8 per node; the steps only need
+		// to shrink, so an inexact step (the conjugate gradient at its iteration limit) is not an error by itself
+		vector<double> residual(n), step(n), slope((size_t) numCell*numBatch);
+		vector<bool> done(numBatch, false);
+		converged = false;
+		for (int iteration=0; iteration<NEWTON_MAX_ITERATION && !converged; iteration++) {
+			Multiply(&x[0], &residual[0], numBatch, NULL, 0);
+			for (int p=0; p<numCell; p++) {
+				double *r = &residual[(size_t) p*numBatch], *c = &residual[(size_t) (numCell+p)*numBatch];
+				const double *vr = &x[(size_t) p*numBatch], *vc = &x[(size_t) (numCell+p)*numBatch];
+				for (int k=0; k<numBatch; k++) {
+					double I = CellCurrent(conductance[p], vr[k]-vc[k], &slope[(size_t) k*numCell+p]);
+					r[k] += I;
+					c[k] -= I;
+				}
+			}
+			for (size_t m=0; m<n; m++) {
+				residual[m] = b[m] - residual[m];
+			}
+			ConjugateGradient(&residual[0], &step[0], numBatch, &slope[0], numCell);
+			
+			// a converged problem is left as it is, so that its solution does not depend on the others of the batch
+			converged = true;
+			for (int k=0; k<numBatch; k++) {
+				if (done[k]) {
+					continue;
+				}
+				double maxStep = 0;
+				for (size_t m=k; m<n; m+=numBatch) {
+					maxStep = max(maxStep, fabs(step[m]));
+				}
+				double damping = min(1.0, halfWriteVoltage/4/maxStep);
+				for (size_t m=k; m<n; m+=numBatch) {
+					x[m] += damping*step[m];
+				}
+				done[k] = maxStep <= 1e-9*readVoltage;
+				converged = converged && done[k];
+			}
+		}
+	}
+	
+	for (int k=0; k<numBatch; k++) {
+		for (int j=0; j<numCol; j++) {
+			current[k*numCol+j] = conductanceCol * x[(size_t) (numCell+(numRow-1)*numCol+j)*numBatch + k];
+		}
+	}
+	return converged;
+}
+
+// y = A x, the conductance of cell p in problem k is g[k*stride+p], g NULL: the wires only
+void CrossbarSolver::Multiply(const double *x, double *y, int numBatch, const double *g, size_t stride) const {
+	int numCell = numRow*numCol;
+	for (int i=0; i<numRow; i++) {
+		for (int j=0; j<numCol; j++) {
+			int p = i*numCol+j;
+			const double *vr = x + (size_t) p*numBatch, *vc = x + (size_t) (numCell+p)*numBatch;
+			double *yr = y + (size_t) p*numBatch, *yc = y + (size_t) (numCell+p)*numBatch;
+			// neighbours on the wires, a missing one (driver, ground or the end of the line) points at the node itself with weight 0
+			double left = j? conductanceRow : 0, right = j+1 < numCol? conductanceRow : 0;
+			double up = i? conductanceCol : 0, down = i+1 < numRow? conductanceCol : 0;
+			const double *vLeft = j? vr-numBatch : vr, *vRight = j+1 < numCol? vr+numBatch : vr;
+			const double *vUp = i? vc-(size_t) numCol*numBatch : vc, *vDown = i+1 < numRow? vc+(size_t) numCol*numBatch : vc;
+			double diagonalRow = conductanceRow + right, diagonalCol = conductanceCol + up;
+			const double *gp = g? g+p : NULL;
+			for (int k=0; k<numBatch; k++) {
+				double sumRow = diagonalRow*vr[k] - left*vLeft[k] - right*vRight[k];
+				double sumCol = diagonalCol*vc[k] - up*vUp[k] - down*vDown[k];
+				if (gp) {
+					double I = gp[k*stride]*(vr[k]-vc[k]);
+					sumRow += I;
+					sumCol -= I;
+				}
+				yr[k] = sumRow;
+				yc[k] = sumCol;
+			}
+		}
+	}
+}
+
+// z = M^-1 r, forward and back substitution along every row and column line
+void CrossbarSolver::Precondition(const double *r, double *z, int numBatch) const {
+	int numCell = numRow*numCol;
+	size_t step = numBatch, line = (size_t) numCol*numBatch;
+	for (int i=0; i<numRow; i++) {
+		size_t first = (size_t) i*numCol;
+		Substitute(r + first*step, z + first*step, &lower[first], &inversePivot[first], conductanceRow, numCol, step, 1, numBatch);
+	}
+	// column line j: the nodes j, j+numCol, ... of the second half; its factors are strided the same way
+	for (int j=0; j<numCol; j++) {
+		size_t first = (size_t) numCell+j;
+		Substitute(r + first*step, z + first*step, &lower[first], &inversePivot[first], conductanceCol, numRow, line, numCol, numBatch);
+	}
+}
+
+// tridiagonal solve of one line of length nodes, its off-diagonal is -conductance; node t of the line is at t*step in r and z
+// (numBatch values each) and at t*factorStep in the factors
+void CrossbarSolver::Substitute(const double *r, double *z, const double *lowerLine, const double *inversePivotLine, double conductance, 
+								int length, size_t step, size_t factorStep, int numBatch) const {
+	for (int k=0; k<numBatch; k++) {
+		z[k] = r[k];
+	}
+	for (int t=1; t<length; t++) {
+		double l = lowerLine[t*factorStep];
+		const double *rt = r + t*step;
+		double *zt = z + t*step, *zPrevious = zt - step;
+		for (int k=0; k<numBatch; k++) {
+			zt[k] = rt[k] - l*zPrevious[k];
+		}
+	}
+	double d = inversePivotLine[(length-1)*factorStep];
+	double *zLast = z + (length-1)*step;
+	for (int k=0; k<numBatch; k++) {
+		zLast[k] *= d;
+	}
+	for (int t=length-2; t>=0; t--) {
+		double d = inversePivotLine[t*factorStep];
+		double *zt = z + t*step, *zNext = zt + step;
+		for (int k=0; k<numBatch; k++) {
+			zt[k] = (zt[k] + conductance*zNext[k]) * d;
+		}
+	}
+}
+
+// preconditioned conjugate gradient on numBatch right-hand sides at once, each one with its own step sizes and stopped
+// on its own residual; x starts from 0, returns false if some of them did not converge within CG_MAX_ITERATION iterations
+bool CrossbarSolver::ConjugateGradient(const double *b, double *x, int numBatch, const double *g, size_t stride) const {
+	size_t numNode = (size_t) 2*numRow*numCol, n = numNode*numBatch;
+	vector<double> r(b, b+n), z(n), p(n), q(n);
+	double rz[BATCH] = {0}, rzNew[BATCH], bound[BATCH] = {0}, alpha[BATCH], beta[BATCH], rr[BATCH];
+	fill(x, x+n, 0);
+	Precondition(&r[0], &z[0], numBatch);
+	p = z;
+	for (size_t m=0; m<n; m+=numBatch) {
+		for (int k=0; k<numBatch; k++) {
+			rz[k] += r[m+k]*z[m+k];
+			bound[k] += r[m+k]*r[m+k];
+		}
+	}
+	int numActive = 0;
+	for (int k=0; k<numBatch; k++) {
+		bound[k] *= CG_TOLERANCE*CG_TOLERANCE;
+		numActive += bound[k] > 0;
+	}
+	
+	// a converged right-hand side keeps alpha = 0 from then on, so its x and r stay as they are
+	int iteration = 0;
+	while (numActive > 0 && iteration < CG_MAX_ITERATION) {
+		iteration++;
+		Multiply(&p[0], &q[0], numBatch, g, stride);
+		fill(alpha, alpha+numBatch, 0);
+		for (size_t m=0; m<n; m+=numBatch) {
+			for (int k=0; k<numBatch; k++) {
+				alpha[k] += p[m+k]*q[m+k];
+			}
+		}
+		for (int k=0; k<numBatch; k++) {
+			alpha[k] = bound[k] > 0? rz[k]/alpha[k] : 0;
+		}
+		fill(rr, rr+numBatch, 0);
+		for (size_t m=0; m<n; m+=numBatch) {
+			for (int k=0; k<numBatch; k++) {
+				x[m+k] += alpha[k]*p[m+k];
+				r[m+k] -= alpha[k]*q[m+k];
+				rr[k] += r[m+k]*r[m+k];
+			}
+		}
+		for (int k=0; k<numBatch; k++) {
+			if (bound[k] > 0 && rr[k] <= bound[k]) {
+				bound[k] = 0;
+				numActive--;
+			}
+		}
+		if (numActive == 0) {
+			break;
+		}
+		Precondition(&r[0], &z[0], numBatch);
+		fill(rzNew, rzNew+numBatch, 0);
+		for (size_t m=0; m<n; m+=numBatch) {
+			for (int k=0; k<numBatch; k++) {
+				rzNew[k] += r[m+k]*z[m+k];
+			}
+		}
+		for (int k=0; k<numBatch; k++) {
+			beta[k] = bound[k] > 0? rzNew[k]/rz[k] : 0;
+			rz[k] = rzNew[k];
+		}
+		for (size_t m=0; m<n; m+=numBatch) {
+			for (int k=0; k<numBatch; k++) {
+				p[m+k] = z[m+k] + beta[k]*p[m+k];
+			}
+		}
+	}
+	return numActive == 0;
+}
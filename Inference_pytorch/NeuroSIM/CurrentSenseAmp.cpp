@@ -118,7 +118,9 @@ void CurrentSenseAmp::CalculateLatency(const vector<double> &columnResistance, d
 		for (double i=0; i<Group; i++) {
 			for (double j=0; j<numColMuxed; j++){
 				double T_Col = 0;
-				T_Col = GetColumnLatency(columnResistance[i*numColMuxed+j]);
+				if (i*numColMuxed+j < columnResistance.size()) {	// columns past the mapped weights are unused
+					T_Col = GetColumnLatency(columnResistance[i*numColMuxed+j]);
+				}
 				LatencyCol = max(LatencyCol, T_Col);
 				if (LatencyCol < 1e-9) {
 					LatencyCol = 1e-9;
@@ -140,7 +142,7 @@ void CurrentSenseAmp::CalculatePower(const vector<double> &columnResistance, dou
 		leakage = 0;
 		readDynamicEnergy = 0;
 		
-		for (double i=0; i<numCol; i++) {
+		for (double i=0; i<numCol && i<columnResistance.size(); i++) {
 			double P_Col = 0, T_Col = 0;
 			T_Col = GetColumnLatency(columnResistance[i]);
 			P_Col = GetColumnPower(columnResistance[i]);
@@ -39,6 +39,7 @@
 #include <cmath>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "constant.h"
 #include "formula.h"
 #include "Param.h"
@@ -137,7 +138,9 @@ void MultilevelSenseAmp::CalculateLatency(const vector<double> &columnResistance
 			double LatencyCol = 0;
 			for (double j=0; j<numCol; j++){
 				double T_Col = 0;
-				T_Col = GetColumnLatency(columnResistance[i*numColMuxed+j]);
+				if (i*numColMuxed+j < columnResistance.size()) {	// columns past the mapped weights are unused
+					T_Col = GetColumnLatency(columnResistance[i*numColMuxed+j]);
+				}
 				LatencyCol = max(LatencyCol, T_Col);
 				if (LatencyCol < 5e-10) {
 					LatencyCol = 5e-10;
@@ -159,7 +162,7 @@ void MultilevelSenseAmp::CalculatePower(const vector<double> &columnResistance,
 		leakage = 0;
 		readDynamicEnergy = 0;
 		
-		for (double i=0; i<numCol; i++) {
+		for (double i=0; i<numCol && i<columnResistance.size(); i++) {
 			double P_Col = 0, T_Col = 0;
 			T_Col = GetColumnLatency(columnResistance[i]);
 			P_Col = GetColumnPower(columnResistance[i]);
@@ -322,3 +325,8 @@ double MultilevelSenseAmp::GetColumnPower(double columnRes) {
 	return Column_Power;
 	
 }
+
+// digital output of the sense amp for a column resistance: the # of references below it
+int MultilevelSenseAmp::GetColumnLevel(double columnRes) const {
+	return lower_bound(Rref.begin(), Rref.end(), columnRes) - Rref.begin();
+}
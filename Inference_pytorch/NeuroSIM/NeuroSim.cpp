@@ -0,0 +1,575 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdlib.h>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include "constant.h"
+#include "formula.h"
+#include "Param.h"
+#include "Tile.h"
+#include "Chip.h"
+#include "ProcessingUnit.h"
+#include "MonteCarlo.h"
+#include "NeuroSim.h"
+
+using namespace std;
+
+extern Param *param;
+extern InputParameter inputParameter;
+extern Technology tech;
+extern MemCell cell;
+
+void NeuroSimFloorPlan(const vector<vector<double> > &netStructure, int synapseBit, int numBitInput, ChipDesign *design) {
+	
+	design->netStructure = netStructure;
+	
+	// define weight/input/memory precision from wrapper
+	param->synapseBit = synapseBit;              // precision of synapse weight
+	param->numBitInput = numBitInput;            // precision of input neural activation
+	if (param->cellBit > param->synapseBit) {
+		cout << "ERROR!: Memory precision is even higher than synapse precision, please modify 'cellBit' in Param.cpp!" << endl;
+		param->cellBit = param->synapseBit;
+	}
+	param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit); 
+	param->numRowPerSynapse = 1;
+	
+	design->synapseBit = param->synapseBit;
+	design->numBitInput = param->numBitInput;
+	design->cellBit = param->cellBit;
+	design->numColPerSynapse = param->numColPerSynapse;
+	design->numRowPerSynapse = param->numRowPerSynapse;
+	
+	design->markNM = ChipDesignInitialize(inputParameter, tech, cell, netStructure, &design->maxPESizeNM, &design->maxTileSizeCM, &design->numPENM);
+	
+	FloorPlan plan = ChipFloorPlan(netStructure, design->markNM, design->maxPESizeNM, design->maxTileSizeCM, design->numPENM);
+	design->desiredNumTileNM = plan.desiredNumTileNM;
+	design->desiredPESizeNM = plan.desiredPESizeNM;
+	design->desiredNumTileCM = plan.desiredNumTileCM;
+	design->desiredTileSizeCM = plan.desiredTileSizeCM;
+	design->desiredPESizeCM = plan.desiredPESizeCM;
+	design->numTileRow = plan.numTileRow;
+	design->numTileCol = plan.numTileCol;
+	design->numTileEachLayer = plan.numTileEachLayer;
+	design->utilizationEachLayer = plan.utilizationEachLayer;
+	design->speedUpEachLayer = plan.speedUpEachLayer;
+	design->tileLocaEachLayer = plan.tileLocaEachLayer;
+}
+
+
+void NeuroSimInitialize(ChipDesign *design) {
+	
+	NeuroSimLoadPrecision(*design);
+	ChipInitialize(inputParameter, tech, cell, design->netStructure, design->markNM, design->numTileEachLayer,
+					design->numPENM, design->desiredNumTileNM, design->desiredPESizeNM, design->desiredNumTileCM, design->desiredTileSizeCM, design->desiredPESizeCM, design->numTileRow, design->numTileCol);
+	
+	design->CMTileheight = 0;
+	design->CMTilewidth = 0;
+	design->NMTileheight = 0;
+	design->NMTilewidth = 0;
+	design->chipAreaResults = ChipCalculateArea(inputParameter, tech, cell, design->desiredNumTileNM, design->numPENM, design->desiredPESizeNM, design->desiredNumTileCM, design->desiredTileSizeCM, design->desiredPESizeCM, design->numTileRow, 
+					&design->chipHeight, &design->chipWidth, &design->CMTileheight, &design->CMTilewidth, &design->NMTileheight, &design->NMTilewidth);
+	
+	// ChipInitialize left the modules of this design loaded in the calling thread
+	design->modules = ChipSaveContext();
+}
+
+
+void NeuroSimFree(ChipDesign *design) {
+	ChipFreeContext(design->modules);
+}
+
+
+// param is process-wide, put back the precision of this design before evaluating it
+void NeuroSimLoadPrecision(const ChipDesign &design) {
+	param->synapseBit = design.synapseBit;
+	param->numBitInput = design.numBitInput;
+	param->cellBit = design.cellBit;
+	param->numColPerSynapse = design.numColPerSynapse;
+	param->numRowPerSynapse = design.numRowPerSynapse;
+}
+
+
+// evaluate one layer on a private copy of the modules, the modules loaded in the calling thread are left untouched
+void NeuroSimCalculateLayer(const ChipDesign &design, int layer, const WeightMatrix &weight, const BitPlane &input, LayerPerformance *result, MonteCarloStream *variation) {
+	
+	ChipContext saved = ChipSaveContext();
+	ChipContext context = ChipCloneContext(design.modules);
+	ChipLoadContext(context);
+	
+	LayerPerformance &p = *result;
+	SamplingStatistics sampling = {0, 0, {0}};
+	p.sampling = sampling;
+	ChipCalculatePerformance(cell, layer, weight, input, design.netStructure[layer][6],
+				design.netStructure, design.markNM, design.numTileEachLayer, design.utilizationEachLayer, design.speedUpEachLayer, design.tileLocaEachLayer,
+				design.numPENM, design.desiredPESizeNM, design.desiredTileSizeCM, design.desiredPESizeCM, design.CMTileheight, design.CMTilewidth, design.NMTileheight, design.NMTilewidth,
+				&p.readLatency, &p.readDynamicEnergy, &p.leakage, &p.bufferLatency, &p.bufferDynamicEnergy, &p.icLatency, &p.icDynamicEnergy,
+				&p.latencyADC, &p.latencyAccum, &p.latencyOther, &p.energyADC, &p.energyAccum, &p.energyOther, variation, &p.sampling);
+	
+	ChipLoadContext(saved);
+	ChipFreeContext(context);
+}
+
+
+ChipPerformance NeuroSimCalculatePerformance(const ChipDesign &design, const vector<WeightMatrix> &weight, const vector<BitPlane> &input) {
+	
+	NeuroSimLoadPrecision(design);
+	
+	// same schedule as main: one task per layer, the tile tasks inside share the team
+	int numLayer = design.netStructure.size();
+	vector<LayerPerformance> layerPerformance(numLayer);
+	
+	#pragma omp parallel
+	#pragma omp single
+	for (int i=0; i<numLayer; i++) {
+		#pragma omp task default(shared) firstprivate(i)
+		NeuroSimCalculateLayer(design, i, weight[i], input[i], &layerPerformance[i]);
+	}
+	
+	return NeuroSimSummarize(design, layerPerformance);
+}
+
+
+ChipPerformance NeuroSimSummarize(const ChipDesign &design, const vector<LayerPerformance> &layerPerformance) {
+	
+	const vector<vector<double> > &netStructure = design.netStructure;
+	const vector<vector<double> > &numTileEachLayer = design.numTileEachLayer;
+	
+	ChipPerformance performance;
+	performance.layer = layerPerformance;
+	performance.readLatency = 0;
+	performance.readDynamicEnergy = 0;
+	performance.leakageEnergy = 0;
+	performance.leakage = 0;
+	performance.bufferLatency = 0;
+	performance.bufferDynamicEnergy = 0;
+	performance.icLatency = 0;
+	performance.icDynamicEnergy = 0;
+	
+	performance.latencyADC = 0;
+	performance.latencyAccum = 0;
+	performance.latencyOther = 0;
+	performance.energyADC = 0;
+	performance.energyAccum = 0;
+	performance.energyOther = 0;
+	
+	performance.numComputation = 0;
+	SamplingStatistics sampling = {0, 0, {0}};
+	performance.sampling = sampling;
+	for (int i=0; i<netStructure.size(); i++) {
+		performance.numComputation += netStructure[i][0] * netStructure[i][1] * netStructure[i][2] * netStructure[i][3] * netStructure[i][4] * netStructure[i][5];
+	}
+	
+	for (int i=0; i<netStructure.size(); i++) {
+		const LayerPerformance &p = layerPerformance[i];
+		double tileLeakage = p.leakage;
+		
+		double numTileOtherLayer = 0;
+		double layerLeakageEnergy = 0;		
+		for (int j=0; j<netStructure.size(); j++) {
+			if (j != i) {
+				numTileOtherLayer += numTileEachLayer[0][j] * numTileEachLayer[1][j];
+			}
+		}
+		layerLeakageEnergy = numTileOtherLayer*p.readLatency*tileLeakage;
+		performance.layerLeakageEnergy.push_back(layerLeakageEnergy);
+		
+		performance.readLatency += p.readLatency;
+		performance.readDynamicEnergy += p.readDynamicEnergy;
+		performance.leakageEnergy += layerLeakageEnergy;
+		performance.leakage += tileLeakage*numTileEachLayer[0][i] * numTileEachLayer[1][i];
+		performance.bufferLatency += p.bufferLatency;
+		performance.bufferDynamicEnergy += p.bufferDynamicEnergy;
+		performance.icLatency += p.icLatency;
+		performance.icDynamicEnergy += p.icDynamicEnergy;
+		
+		performance.latencyADC += p.latencyADC;
+		performance.latencyAccum += p.latencyAccum;
+		performance.latencyOther += p.latencyOther;
+		performance.energyADC += p.energyADC;
+		performance.energyAccum += p.energyAccum;
+		performance.energyOther += p.energyOther;
+		
+		performance.sampling.numVector += p.sampling.numVector;
+		performance.sampling.numSampled += p.sampling.numSampled;
+		for (int f=0; f<9; f++) {
+			performance.sampling.relativeError[f] = max(performance.sampling.relativeError[f], p.sampling.relativeError[f]);
+		}
+	}
+	return performance;
+}
+
+
+void NeuroSimPrintFloorPlan(const ChipDesign &design) {
+	
+	const vector<vector<double> > &netStructure = design.netStructure;
+	const vector<vector<double> > &numTileEachLayer = design.numTileEachLayer;
+	const vector<vector<double> > &utilizationEachLayer = design.utilizationEachLayer;
+	const vector<vector<double> > &speedUpEachLayer = design.speedUpEachLayer;
+	double desiredTileSizeCM = design.desiredTileSizeCM;
+	double desiredPESizeCM = design.desiredPESizeCM;
+	double desiredPESizeNM = design.desiredPESizeNM;
+	double numPENM = design.numPENM;
+	
+	cout << "------------------------------ FloorPlan --------------------------------" <<  endl;
+	cout << endl;
+	if (param->floorPlanSearch == 1 && param->floorPlanMetric == 1) {
+		cout << "Tile and PE size are optimized to minimize the # of tiles, then to maximize memory utilization ( = memory mapped by synapse / total memory on chip)" << endl;
+	} else {
+		cout << "Tile and PE size are optimized to maximize memory utilization ( = memory mapped by synapse / total memory on chip)" << endl;
+	}
+	cout << endl;
+	if (!param->novelMapping) {
+		cout << "Desired Conventional Mapped Tile Storage Size: " << desiredTileSizeCM << "x" << desiredTileSizeCM << endl;
+		cout << "Desired Conventional PE Storage Size: " << desiredPESizeCM << "x" << desiredPESizeCM << endl;
+	} else {
+		cout << "Desired Conventional Mapped Tile Storage Size: " << desiredTileSizeCM << "x" << desiredTileSizeCM << endl;
+		cout << "Desired Conventional PE Storage Size: " << desiredPESizeCM << "x" << desiredPESizeCM << endl;
+		cout << "Desired Novel Mapped Tile Storage Size: " << numPENM << "x" << desiredPESizeNM << "x" << desiredPESizeNM << endl;
+	}
+	cout << "User-defined SubArray Size: " << param->numRowSubArray << "x" << param->numColSubArray << endl;
+	cout << endl;
+	cout << "----------------- # of tile used for each layer -----------------" <<  endl;
+	double totalNumTile = 0;
+	for (int i=0; i<netStructure.size(); i++) {
+		cout << "layer" << i+1 << ": " << numTileEachLayer[0][i] * numTileEachLayer[1][i] << endl;
+		totalNumTile += numTileEachLayer[0][i] * numTileEachLayer[1][i];
+	}
+	cout << endl;
+
+	cout << "----------------- Speed-up of each layer ------------------" <<  endl;
+	for (int i=0; i<netStructure.size(); i++) {
+		cout << "layer" << i+1 << ": " << speedUpEachLayer[0][i] << ", " << speedUpEachLayer[1][i] << endl;
+	}
+	cout << endl;
+	
+	cout << "----------------- Utilization of each layer ------------------" <<  endl;
+	double realMappedMemory = 0;
+	for (int i=0; i<netStructure.size(); i++) {
+		cout << "layer" << i+1 << ": " << utilizationEachLayer[i][0] << endl;
+		realMappedMemory += numTileEachLayer[0][i] * numTileEachLayer[1][i] * utilizationEachLayer[i][0];
+	}
+	cout << "Memory Utilization of Whole Chip: " << realMappedMemory/totalNumTile*100 << " % " << endl;
+	cout << endl;
+	cout << "---------------------------- FloorPlan Done ------------------------------" <<  endl;
+	cout << endl;
+	cout << endl;
+	cout << endl;
+}
+
+
+void NeuroSimPrintPerformance(const ChipDesign &design, const ChipPerformance &performance) {
+	
+	const vector<vector<double> > &netStructure = design.netStructure;
+	const vector<vector<double> > &numTileEachLayer = design.numTileEachLayer;
+	
+	cout << "-------------------------------------- Hardware Performance --------------------------------------" <<  endl;
+	
+	for (int i=0; i<netStructure.size(); i++) {
+		
+		cout << "-------------------- Estimation of Layer " << i+1 << " ----------------------" << endl;
+		
+		const LayerPerformance &p = performance.layer[i];
+		double layerReadLatency = p.readLatency;
+		double layerReadDynamicEnergy = p.readDynamicEnergy;
+		double tileLeakage = p.leakage;
+		double layerbufferLatency = p.bufferLatency;
+		double layerbufferDynamicEnergy = p.bufferDynamicEnergy;
+		double layericLatency = p.icLatency;
+		double layericDynamicEnergy = p.icDynamicEnergy;
+		
+		double coreLatencyADC = p.latencyADC;
+		double coreLatencyAccum = p.latencyAccum;
+		double coreLatencyOther = p.latencyOther;
+		double coreEnergyADC = p.energyADC;
+		double coreEnergyAccum = p.energyAccum;
+		double coreEnergyOther = p.energyOther;
+		
+		double layerLeakageEnergy = performance.layerLeakageEnergy[i];
+		
+		cout << "layer" << i+1 << "'s readLatency is: " << layerReadLatency*1e9 << "ns" << endl;
+		cout << "layer" << i+1 << "'s readDynamicEnergy is: " << layerReadDynamicEnergy*1e12 << "pJ" << endl;
+		cout << "layer" << i+1 << "'s leakagePower is: " << numTileEachLayer[0][i] * numTileEachLayer[1][i] * tileLeakage*1e6 << "uW" << endl;
+		cout << "layer" << i+1 << "'s leakageEnergy is: " << layerLeakageEnergy*1e12 << "pJ" << endl;
+		cout << "layer" << i+1 << "'s buffer latency is: " << layerbufferLatency*1e9 << "ns" << endl;
+		cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << layerbufferDynamicEnergy*1e12 << "pJ" << endl;
+		cout << "layer" << i+1 << "'s ic latency is: " << layericLatency*1e9 << "ns" << endl;
+		cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << layericDynamicEnergy*1e12 << "pJ" << endl;
+		
+		
+		cout << endl;
+		cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+		cout << endl;
+		cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreLatencyADC*1e9 << "ns" << endl;
+		cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreLatencyAccum*1e9 << "ns" << endl;
+		cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreLatencyOther*1e9 << "ns" << endl;
+		cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreEnergyADC*1e12 << "pJ" << endl;
+		cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreEnergyAccum*1e12 << "pJ" << endl;
+		cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreEnergyOther*1e12 << "pJ" << endl;
+		cout << endl;
+		cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+		cout << endl;
+	}
+	
+	double chipArea = design.chipAreaResults[0];
+	double chipAreaIC = design.chipAreaResults[1];
+	double chipAreaADC = design.chipAreaResults[2];
+	double chipAreaAccum = design.chipAreaResults[3];
+	double chipAreaOther = design.chipAreaResults[4];
+	
+	double chipReadLatency = performance.readLatency;
+	double chipReadDynamicEnergy = performance.readDynamicEnergy;
+	double chipLeakageEnergy = performance.leakageEnergy;
+	double chipLeakage = performance.leakage;
+	double chipbufferLatency = performance.bufferLatency;
+	double chipbufferReadDynamicEnergy = performance.bufferDynamicEnergy;
+	double chipicLatency = performance.icLatency;
+	double chipicReadDynamicEnergy = performance.icDynamicEnergy;
+	
+	double chipLatencyADC = performance.latencyADC;
+	double chipLatencyAccum = performance.latencyAccum;
+	double chipLatencyOther = performance.latencyOther;
+	double chipEnergyADC = performance.energyADC;
+	double chipEnergyAccum = performance.energyAccum;
+	double chipEnergyOther = performance.energyOther;
+	double numComputation = performance.numComputation;
+	
+	cout << "------------------------------ Summary --------------------------------" <<  endl;
+	cout << endl;
+	cout << "ChipArea : " << chipArea*1e12 << "um^2" << endl;
+	cout << "Total IC Area on chip (Global and Tile/PE local): " << chipAreaIC*1e12 << "um^2" << endl;
+	cout << "Total ADC (or S/As and precharger for SRAM) Area on chip : " << chipAreaADC*1e12 << "um^2" << endl;
+	cout << "Total Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) on chip : " << chipAreaAccum*1e12 << "um^2" << endl;
+	cout << "Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) : " << chipAreaOther*1e12 << "um^2" << endl;
+	cout << endl;
+	cout << "Chip total readLatency is: " << chipReadLatency*1e9 << "ns" << endl;
+	cout << "Chip total readDynamicEnergy is: " << chipReadDynamicEnergy*1e12 << "pJ" << endl;
+	cout << "Chip total leakage Energy is: " << chipLeakageEnergy*1e12 << "pJ" << endl;
+	cout << "Chip total leakage Power is: " << chipLeakage*1e6 << "uW" << endl;
+	cout << "Chip buffer readLatency is: " << chipbufferLatency*1e9 << "ns" << endl;
+	cout << "Chip buffer readDynamicEnergy is: " << chipbufferReadDynamicEnergy*1e12 << "pJ" << endl;
+	cout << "Chip ic readLatency is: " << chipicLatency*1e9 << "ns" << endl;
+	cout << "Chip ic readDynamicEnergy is: " << chipicReadDynamicEnergy*1e12 << "pJ" << endl;
+	
+	cout << endl;
+	cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+	cout << endl;
+	cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << chipLatencyADC*1e9 << "ns" << endl;
+	cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << chipLatencyAccum*1e9 << "ns" << endl;
+	cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << chipLatencyOther*1e9 << "ns" << endl;
+	cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << chipEnergyADC*1e12 << "pJ" << endl;
+	cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << chipEnergyAccum*1e12 << "pJ" << endl;
+	cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << chipEnergyOther*1e12 << "pJ" << endl;
+	cout << endl;
+	cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
+	cout << endl;
+	
+	cout << endl;
+	cout << "----------------------------- Performance -------------------------------" << endl;
+	cout << "Energy Efficiency TOPS/W (Layer-by-Layer Process): " << numComputation/(chipReadDynamicEnergy*1e12+chipLeakageEnergy*1e12) << endl;
+	cout << "Throughput FPS (Layer-by-Layer Process): " << 1/(chipReadLatency) << endl;
+	if (param->sampleError > 0) {
+		// each sampled figure is given the largest relative error seen in any subArray chunk, which bounds the error of sums and
+		// maxima of chunk totals; the buffer, IC and leakage parts are exact, so the intervals are conservative
+		const SamplingStatistics &sampling = performance.sampling;
+		double errorLatency = max(sampling.relativeError[0], max(sampling.relativeError[3], max(sampling.relativeError[4], sampling.relativeError[5])));
+		double errorEnergy = max(sampling.relativeError[1], max(sampling.relativeError[6], max(sampling.relativeError[7], sampling.relativeError[8])));
+		double energy = chipReadDynamicEnergy*1e12+chipLeakageEnergy*1e12;
+		cout << "----------------------------- Sampling -------------------------------" << endl;
+		cout << "Input vectors simulated: " << sampling.numSampled << " of " << sampling.numVector << " (target relative error " << param->sampleError << ")" << endl;
+		cout << "95% confidence intervals:" << endl;
+		cout << "Chip total readLatency is: " << chipReadLatency*1e9 << " +- " << errorLatency*chipReadLatency*1e9 << "ns" << endl;
+		cout << "Chip total readDynamicEnergy is: " << chipReadDynamicEnergy*1e12 << " +- " << errorEnergy*chipReadDynamicEnergy*1e12 << "pJ" << endl;
+		cout << "----------- ADC readLatency is : " << chipLatencyADC*1e9 << " +- " << sampling.relativeError[3]*chipLatencyADC*1e9 << "ns" << endl;
+		cout << "----------- Accumulation Circuits readLatency is : " << chipLatencyAccum*1e9 << " +- " << sampling.relativeError[4]*chipLatencyAccum*1e9 << "ns" << endl;
+		cout << "----------- Other Peripheries readLatency is : " << chipLatencyOther*1e9 << " +- " << sampling.relativeError[5]*chipLatencyOther*1e9 << "ns" << endl;
+		cout << "----------- ADC readDynamicEnergy is : " << chipEnergyADC*1e12 << " +- " << sampling.relativeError[6]*chipEnergyADC*1e12 << "pJ" << endl;
+		cout << "----------- Accumulation Circuits readDynamicEnergy is : " << chipEnergyAccum*1e12 << " +- " << sampling.relativeError[7]*chipEnergyAccum*1e12 << "pJ" << endl;
+		cout << "----------- Other Peripheries readDynamicEnergy is : " << chipEnergyOther*1e12 << " +- " << sampling.relativeError[8]*chipEnergyOther*1e12 << "pJ" << endl;
+		cout << "Energy Efficiency TOPS/W (Layer-by-Layer Process): " << numComputation/(energy+errorEnergy*chipReadDynamicEnergy*1e12) 
+			 << " to " << numComputation/(energy-errorEnergy*chipReadDynamicEnergy*1e12) << endl;
+		cout << "Throughput FPS (Layer-by-Layer Process): " << 1/(chipReadLatency*(1+errorLatency)) << " to " << 1/(chipReadLatency*(1-errorLatency)) << endl;
+	}
+	cout << "-------------------------------------- Hardware Performance Done --------------------------------------" <<  endl;
+	cout << endl;
+}
+
+
+static double PrintError(const string &name, double exact, double estimate, double scale, const string &unit) {
+	double error = exact != 0? (estimate-exact)/exact : 0;
+	cout << name << ": exact " << exact*scale << unit << ", estimate " << estimate*scale << unit << ", error " << error*100 << "%" << endl;
+	return fabs(error);
+}
+
+
+// error of the fast estimate (param->fastEstimate == 1) against the simulated result of the same network
+void NeuroSimPrintComparison(const ChipDesign &design, const ChipPerformance &exact, const ChipPerformance &estimate) {
+	
+	cout << "------------------------------ Fast Estimate vs Exact --------------------------------" << endl;
+	double maxError = 0;
+	for (int i=0; i<design.netStructure.size(); i++) {
+		ostringstream layer;
+		layer << "layer" << i+1;
+		maxError = max(maxError, PrintError(layer.str()+"'s readLatency", exact.layer[i].readLatency, estimate.layer[i].readLatency, 1e9, "ns"));
+		maxError = max(maxError, PrintError(layer.str()+"'s readDynamicEnergy", exact.layer[i].readDynamicEnergy, estimate.layer[i].readDynamicEnergy, 1e12, "pJ"));
+	}
+	maxError = max(maxError, PrintError("Chip total readLatency", exact.readLatency, estimate.readLatency, 1e9, "ns"));
+	maxError = max(maxError, PrintError("Chip total readDynamicEnergy", exact.readDynamicEnergy, estimate.readDynamicEnergy, 1e12, "pJ"));
+	maxError = max(maxError, PrintError("----------- ADC readLatency", exact.latencyADC, estimate.latencyADC, 1e9, "ns"));
+	maxError = max(maxError, PrintError("----------- Accumulation Circuits readLatency", exact.latencyAccum, estimate.latencyAccum, 1e9, "ns"));
+	maxError = max(maxError, PrintError("----------- Other Peripheries readLatency", exact.latencyOther, estimate.latencyOther, 1e9, "ns"));
+	maxError = max(maxError, PrintError("----------- ADC readDynamicEnergy", exact.energyADC, estimate.energyADC, 1e12, "pJ"));
+	maxError = max(maxError, PrintError("----------- Accumulation Circuits readDynamicEnergy", exact.energyAccum, estimate.energyAccum, 1e12, "pJ"));
+	maxError = max(maxError, PrintError("----------- Other Peripheries readDynamicEnergy", exact.energyOther, estimate.energyOther, 1e12, "pJ"));
+	maxError = max(maxError, PrintError("Energy Efficiency TOPS/W", exact.numComputation/(exact.readDynamicEnergy*1e12+exact.leakageEnergy*1e12), 
+										estimate.numComputation/(estimate.readDynamicEnergy*1e12+estimate.leakageEnergy*1e12), 1, ""));
+	maxError = max(maxError, PrintError("Throughput FPS", 1/exact.readLatency, 1/estimate.readLatency, 1, ""));
+	cout << "Largest error of the fast estimate: " << maxError*100 << "%" << endl;
+	cout << "------------------------------ Fast Estimate vs Exact --------------------------------" << endl;
+	cout << endl;
+}
+
+
+static void PrintDistribution(const string &name, const vector<double> &values, const string &unit) {
+	double mean = 0, variance = 0;
+	for (int t=0; t<values.size(); t++) {
+		mean += values[t];
+	}
+	mean /= values.size();
+	for (int t=0; t<values.size(); t++) {
+		variance += (values[t]-mean)*(values[t]-mean);
+	}
+	double sigma = values.size() > 1? sqrt(variance/(values.size()-1)) : 0;
+	cout << name << ": mean " << mean << unit << ", sigma " << sigma << unit << ", min " << *min_element(values.begin(), values.end()) << unit 
+		 << ", max " << *max_element(values.begin(), values.end()) << unit << endl;
+}
+
+
+// distributions over the Monte Carlo trials (param->monteCarloTrials) of the chip figures and of the ADC output error
+void NeuroSimPrintMonteCarlo(const vector<ChipPerformance> &trials, const vector<vector<MonteCarloStream> > &streams) {
+	
+	int numTrial = trials.size();
+	vector<double> latency(numTrial), energy(numTrial), efficiency(numTrial), levelErrorRate(numTrial), levelError(numTrial);
+	long long numColumnRead = 0;
+	for (int t=0; t<numTrial; t++) {
+		const ChipPerformance &p = trials[t];
+		latency[t] = p.readLatency*1e9;
+		energy[t] = p.readDynamicEnergy*1e12;
+		efficiency[t] = p.numComputation/(p.readDynamicEnergy*1e12+p.leakageEnergy*1e12);
+		long long numRead = 0, numError = 0, sumError = 0;
+		for (int i=0; i<streams[t].size(); i++) {
+			numRead += streams[t][i].numColumnRead;
+			numError += streams[t][i].numLevelError;
+			sumError += streams[t][i].sumLevelError;
+		}
+		levelErrorRate[t] = numRead? (double) numError/numRead*100 : 0;
+		levelError[t] = numRead? (double) sumError/numRead : 0;
+		numColumnRead = numRead;
+	}
+	
+	cout << "------------------------------ Monte Carlo --------------------------------" << endl;
+	cout << numTrial << " trials (seed " << param->monteCarloSeed << "), readNoise " << param->readNoise << ", deviceVariation " << param->deviceVariation 
+		 << ", stuckAtOnRate " << param->stuckAtOnRate << ", stuckAtOffRate " << param->stuckAtOffRate << endl;
+	PrintDistribution("Chip total readLatency", latency, "ns");
+	PrintDistribution("Chip total readDynamicEnergy", energy, "pJ");
+	PrintDistribution("Energy Efficiency TOPS/W (Layer-by-Layer Process)", efficiency, "");
+	if (numColumnRead) {
+		cout << "ADC conversions per trial: " << numColumnRead << endl;
+		PrintDistribution("ADC outputs off the nominal level", levelErrorRate, "%");
+		PrintDistribution("ADC output error per conversion", levelError, " levels");
+	} else {
+		cout << "ADC output error: no multilevel sense amp conversions (SRAM or parallelRead off)" << endl;
+	}
+	cout << "------------------------------ Monte Carlo --------------------------------" << endl;
+	cout << endl;
+}
+
+
+vector<vector<double> > getNetStructure(const string &inputfile) {
+	ifstream infile(inputfile.c_str());      
+	string inputline;
+	string inputval;
+
+	int ROWin=0, COLin=0;      
+	if (!infile.good()) {        
+		cerr << "Error: the input file cannot be opened!" << endl;
+		exit(1);
+	}else{
+		while (getline(infile, inputline, '\n')) {       
+			ROWin++;                                
+		}
+		infile.clear();
+		infile.seekg(0, ios::beg);      
+		if (getline(infile, inputline, '\n')) {        
+			istringstream iss (inputline);      
+			while (getline(iss, inputval, ',')) {       
+				COLin++;
+			}
+		}	
+	}
+	infile.clear();
+	infile.seekg(0, ios::beg);          
+
+	vector<vector<double> > netStructure;               
+	for (int row=0; row<ROWin; row++) {	
+		vector<double> netStructurerow;
+		getline(infile, inputline, '\n');             
+		istringstream iss;
+		iss.str(inputline);
+		for (int col=0; col<COLin; col++) {       
+			while(getline(iss, inputval, ',')){	
+				istringstream fs;
+				fs.str(inputval);
+				double f=0;
+				fs >> f;				
+				netStructurerow.push_back(f);			
+			}			
+		}		
+		netStructure.push_back(netStructurerow);
+	}
+	infile.close();
+	
+	return netStructure;
+	netStructure.clear();
+}
@@ -42,7 +42,10 @@
 #include <string>
 #include <stdlib.h>
 #include <vector>
+#include <algorithm>
 #include <sstream>
+#include <random>
+#include <omp.h>
 #include "Bus.h"
 #include "SubArray.h"
 #include "constant.h"
@@ -52,16 +55,63 @@
 #include "AdderTree.h"
 #include "Bus.h"
 #include "DFF.h"
+#include "MonteCarlo.h"
+#include "CrossbarSolver.h"
 
 using namespace std;
 
 extern Param *param;
 
+static void ConvertColumnResistance(const vector<double> &columnG, double activatedRow, MemCell& cell, bool parallelRead, vector<double> &resistance);
+
 AdderTree *adderTree;
 Bus *busInput;
 Bus *busOutput;
 DFF *bufferInput;
 DFF *bufferOutput;
+ProcessingUnitScratch *scratch;
+#pragma omp threadprivate(adderTree, busInput, busOutput, bufferInput, bufferOutput, scratch)
+
+ProcessingUnitContext ProcessingUnitSaveContext() {
+	ProcessingUnitContext context;
+	context.adderTree = adderTree;
+	context.busInput = busInput;
+	context.busOutput = busOutput;
+	context.bufferInput = bufferInput;
+	context.bufferOutput = bufferOutput;
+	context.scratch = scratch;
+	return context;
+}
+
+void ProcessingUnitLoadContext(const ProcessingUnitContext &context) {
+	adderTree = context.adderTree;
+	busInput = context.busInput;
+	busOutput = context.busOutput;
+	bufferInput = context.bufferInput;
+	bufferOutput = context.bufferOutput;
+	scratch = context.scratch;
+}
+
+ProcessingUnitContext ProcessingUnitCloneContext(const ProcessingUnitContext &context) {
+	ProcessingUnitContext copy;
+	copy.adderTree = context.adderTree? new AdderTree(*context.adderTree) : NULL;
+	copy.busInput = context.busInput? new Bus(*context.busInput) : NULL;
+	copy.busOutput = context.busOutput? new Bus(*context.busOutput) : NULL;
+	copy.bufferInput = context.bufferInput? new DFF(*context.bufferInput) : NULL;
+	copy.bufferOutput = context.bufferOutput? new DFF(*context.bufferOutput) : NULL;
+	copy.scratch = context.scratch? new ProcessingUnitScratch() : NULL;	// contents are not carried over, only the buffers are private
+	return copy;
+}
+
+void ProcessingUnitFreeContext(ProcessingUnitContext &context) {
+	delete context.adderTree;
+	delete context.busInput;
+	delete context.busOutput;
+	delete context.bufferInput;
+	delete context.bufferOutput;
+	delete context.scratch;
+	context = ProcessingUnitContext();
+}
 
 void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int _numSubArrayRow, int _numSubArrayCol) {
 
@@ -103,6 +153,7 @@ void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParamet
 	busOutput = new Bus(inputParameter, tech, cell);
 	bufferInput = new DFF(inputParameter, tech, cell);
 	bufferOutput = new DFF(inputParameter, tech, cell);
+	scratch = new ProcessingUnitScratch();
 		
 	/* Create SubArray object and link the required global objects (not initialization) */
 	inputParameter.temperature = param->temp;   // Temperature (K)
@@ -237,13 +288,13 @@ vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRo
 }
 
 
-double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, 
-											const vector<vector<double> > &inputVector,
+void ProcessingUnitCalculatePerformance(SubArray *subArray, const MatrixView &newMemory, const MatrixView &oldMemory, 
+											const BitPlane &inputVector,
 											int arrayDupRow, int arrayDupCol, int numSubArrayRow, int numSubArrayCol, int weightMatrixRow,
 											int weightMatrixCol, int numInVector, MemCell& cell, double *readLatency, double *readDynamicEnergy, double *leakage, 
 											double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
 											double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, 
-											double *coreEnergyAccum, double *coreEnergyOther) {
+											double *coreEnergyAccum, double *coreEnergyOther, const EvaluationState &evaluation) {
 	
 	/*** define how many subArray are used to map the whole layer ***/
 	*readLatency = 0;
@@ -266,55 +317,76 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 	double subArrayLatencyADC = 0;
 	double subArrayLatencyAccum = 0;
 	double subArrayLatencyOther = 0;
+	vector<SubArray::ReadResult> chunkPerformance;
 
 	if (arrayDupRow*arrayDupCol > 1) {
 		// weight matrix is duplicated among subArray
 		if (arrayDupRow < numSubArrayRow || arrayDupCol < numSubArrayCol) {
 			// a couple of subArrays are mapped by the matrix
 			// need to redefine the data-grab start-point
+			SubArray::ReadResult blockPerformance = {};	// results of the last simulated block summed over its input vectors (leakage: last vector)
+			int blockRow = -1, blockNumCol = -1;
 			for (int i=0; i<ceil((double) weightMatrixRow/(double) param->numRowSubArray); i++) {
 				for (int j=0; j<ceil((double) weightMatrixCol/(double) param->numColSubArray); j++) {
 					int numRowMatrix = min(param->numRowSubArray, weightMatrixRow-i*param->numRowSubArray);
 					int numColMatrix = min(param->numColSubArray, weightMatrixCol-j*param->numColSubArray);
 					
 					if ((i*param->numRowSubArray < weightMatrixRow) && (j*param->numColSubArray < weightMatrixCol) && (i*param->numRowSubArray < weightMatrixRow) ) {
-						// assign weight and input to specific subArray
-						vector<vector<double> > subArrayMemory;
-						subArrayMemory = CopySubArray(newMemory, i*param->numRowSubArray, i*param->numColSubArray, numRowMatrix, numColMatrix);
-						vector<vector<double> > subArrayInput;
-						subArrayInput = CopySubInput(inputVector, i*param->numRowSubArray, numInVector, numRowMatrix);
-						
-						for (int i=0; i<numInVector; i++) {                 // calculate single subArray through the total input vectors
-							double activityRowRead = 0;
-							vector<double> input; 
-							input = GetInputVector(subArrayInput, i, &activityRowRead);
-							subArray->activityRowRead = activityRowRead;
+						// the block and its input only follow i (and the block width), every j of the same i re-reads the identical subArray
+						// --> simulate it once and replay its summed results for the other j, so only one chunk of per-vector results is kept;
+						// in a Monte Carlo trial each j is a separate device with its own variation and is simulated, not replayed
+						EvaluationState subArrayEvaluation = evaluation;
+						subArrayEvaluation.replica = j;
+						if (i != blockRow || numColMatrix != blockNumCol || evaluation.variation) {
+							// assign weight and input to specific subArray
+							// (the column offset follows i as in the original mapping, but is kept inside the weight matrix: past its
+							// last column the view would read the next rows and, for the last rows, beyond the end of the weights)
+							int subArrayCol = min(i*param->numColSubArray, weightMatrixCol-numColMatrix);
+							MatrixView subArrayMemory;
+							subArrayMemory = newMemory.Block(i*param->numRowSubArray, subArrayCol, numRowMatrix, numColMatrix);
+							BitPlane subArrayInput;
+							int subArrayRow = i*param->numRowSubArray;
+							SubArrayConductance conductance(subArrayMemory, cell, subArrayEvaluation);
 							
-							int cellRange = pow(2, param->cellBit);
-							if (param->parallelRead) {
-								subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-							} else {
-								subArray->levelOutput = cellRange;
+							SubArray::ReadResult sum = {};
+							for (int n=0; n<numInVector; n+=param->numVectorPerChunk) {    // calculate single subArray through the total input vectors
+								// stream the input vectors chunk by chunk, the result cache only keeps the current chunk
+								int numChunkVector = min(param->numVectorPerChunk, numInVector-n);
+								subArrayInput = CopySubInput(inputVector, subArrayRow, n, numChunkVector, numRowMatrix);
+								SubArrayCalculateChunk(subArray, subArrayInput, subArrayMemory, conductance, subArrayEvaluation, cell, chunkPerformance);
+								
+								// accumulate in input vector order, independent of how the chunk was split among threads
+								for (int v=0; v<numChunkVector; v++) {
+									const SubArray::ReadResult &result = chunkPerformance[v];
+									sum.readLatency += result.readLatency;
+									sum.readDynamicEnergy += result.readDynamicEnergy;
+									sum.leakage = result.leakage;
+									
+									sum.readLatencyADC += result.readLatencyADC;
+									sum.readLatencyAccum += result.readLatencyAccum;
+									sum.readLatencyOther += result.readLatencyOther;
+									
+									sum.readDynamicEnergyADC += result.readDynamicEnergyADC;
+									sum.readDynamicEnergyAccum += result.readDynamicEnergyAccum;
+									sum.readDynamicEnergyOther += result.readDynamicEnergyOther;
+								}
 							}
-							
-							vector<double> columnResistance;
-							columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-							
-							subArray->CalculateLatency(1e20, columnResistance);
-							subArray->CalculatePower(columnResistance);
-							
-							subArrayReadLatency += subArray->readLatency;
-							*readDynamicEnergy += subArray->readDynamicEnergy;
-							subArrayLeakage = subArray->leakage;
-
-							subArrayLatencyADC += subArray->readLatencyADC;
-							subArrayLatencyAccum += subArray->readLatencyAccum;
-							subArrayLatencyOther += subArray->readLatencyOther;
-							
-							*coreEnergyADC += subArray->readDynamicEnergyADC;
-							*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-							*coreEnergyOther += subArray->readDynamicEnergyOther;
+							blockPerformance = sum;
+							blockRow = i;
+							blockNumCol = numColMatrix;
 						}
+						
+						subArrayReadLatency += blockPerformance.readLatency;
+						*readDynamicEnergy += blockPerformance.readDynamicEnergy;
+						subArrayLeakage = blockPerformance.leakage;
+						
+						subArrayLatencyADC += blockPerformance.readLatencyADC;
+						subArrayLatencyAccum += blockPerformance.readLatencyAccum;
+						subArrayLatencyOther += blockPerformance.readLatencyOther;
+						
+						*coreEnergyADC += blockPerformance.readDynamicEnergyADC;
+						*coreEnergyAccum += blockPerformance.readDynamicEnergyAccum;
+						*coreEnergyOther += blockPerformance.readDynamicEnergyOther;
 						adderTree->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
 						adderTree->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
 						
@@ -337,41 +409,33 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 			*coreLatencyOther = (*coreLatencyOther)/(arrayDupRow*arrayDupCol);
 		} else {
 			// assign weight and input to specific subArray
-			vector<vector<double> > subArrayMemory;
-			subArrayMemory = CopySubArray(newMemory, 0, 0, weightMatrixRow, weightMatrixCol);
-			vector<vector<double> > subArrayInput;
-			subArrayInput = CopySubInput(inputVector, 0, numInVector, weightMatrixRow);
+			MatrixView subArrayMemory;
+			subArrayMemory = newMemory.Block(0, 0, weightMatrixRow, weightMatrixCol);
+			BitPlane subArrayInput;
+			int subArrayRow = 0;
+			SubArrayConductance conductance(subArrayMemory, cell, evaluation);
 			
-			for (int i=0; i<numInVector; i++) {                 // calculate single subArray through the total input vectors
-				double activityRowRead = 0;
-				vector<double> input;
-				input = GetInputVector(subArrayInput, i, &activityRowRead);
-				subArray->activityRowRead = activityRowRead;
-				int cellRange = pow(2, param->cellBit);
+			for (int i=0; i<numInVector; i+=param->numVectorPerChunk) {    // calculate single subArray through the total input vectors
+				// stream the input vectors chunk by chunk, the result cache only keeps the current chunk
+				int numChunkVector = min(param->numVectorPerChunk, numInVector-i);
+				subArrayInput = CopySubInput(inputVector, subArrayRow, i, numChunkVector, weightMatrixRow);
+				SubArrayCalculateChunk(subArray, subArrayInput, subArrayMemory, conductance, evaluation, cell, chunkPerformance);
 				
-				if (param->parallelRead) {
-					subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-				} else {
-					subArray->levelOutput = cellRange;
+				// accumulate in input vector order, independent of how the chunk was split among threads
+				for (int v=0; v<numChunkVector; v++) {
+					const SubArray::ReadResult &result = chunkPerformance[v];
+					subArrayReadLatency += result.readLatency;
+					*readDynamicEnergy += result.readDynamicEnergy;
+					subArrayLeakage = result.leakage;
+					
+					subArrayLatencyADC += result.readLatencyADC;
+					subArrayLatencyAccum += result.readLatencyAccum;
+					subArrayLatencyOther += result.readLatencyOther;
+					
+					*coreEnergyADC += result.readDynamicEnergyADC;
+					*coreEnergyAccum += result.readDynamicEnergyAccum;
+					*coreEnergyOther += result.readDynamicEnergyOther;
 				}
-				
-				vector<double> columnResistance;
-				columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-				
-				subArray->CalculateLatency(1e20, columnResistance);
-				subArray->CalculatePower(columnResistance);
-				
-				subArrayReadLatency += subArray->readLatency;
-				*readDynamicEnergy += subArray->readDynamicEnergy;
-				subArrayLeakage = subArray->leakage;
-				
-				subArrayLatencyADC += subArray->readLatencyADC;
-				subArrayLatencyAccum += subArray->readLatencyAccum;
-				subArrayLatencyOther += subArray->readLatencyOther;
-				
-				*coreEnergyADC += subArray->readDynamicEnergyADC;
-				*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-				*coreEnergyOther += subArray->readDynamicEnergyOther;
 			}
 			// do not pass adderTree 
 			*readLatency = subArrayReadLatency/(arrayDupRow*arrayDupCol);
@@ -389,41 +453,33 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 					int numRowMatrix = min(param->numRowSubArray, weightMatrixRow-i*param->numRowSubArray);
 					int numColMatrix = min(param->numColSubArray, weightMatrixCol-j*param->numColSubArray);
 					// assign weight and input to specific subArray
-					vector<vector<double> > subArrayMemory;
-					subArrayMemory = CopySubArray(newMemory, i*param->numRowSubArray, j*param->numColSubArray, numRowMatrix, numColMatrix);
-					vector<vector<double> > subArrayInput;
-					subArrayInput = CopySubInput(inputVector, i*param->numRowSubArray, numInVector, numRowMatrix);
+					MatrixView subArrayMemory;
+					subArrayMemory = newMemory.Block(i*param->numRowSubArray, j*param->numColSubArray, numRowMatrix, numColMatrix);
+					BitPlane subArrayInput;
+					int subArrayRow = i*param->numRowSubArray;
+					SubArrayConductance conductance(subArrayMemory, cell, evaluation);
 					
-					for (int i=0; i<numInVector; i++) {                 // calculate single subArray through the total input vectors
-						double activityRowRead = 0;
-						vector<double> input;
-						input = GetInputVector(subArrayInput, i, &activityRowRead);
-						subArray->activityRowRead = activityRowRead;
+					for (int i=0; i<numInVector; i+=param->numVectorPerChunk) {    // calculate single subArray through the total input vectors
+						// stream the input vectors chunk by chunk, the result cache only keeps the current chunk
+						int numChunkVector = min(param->numVectorPerChunk, numInVector-i);
+						subArrayInput = CopySubInput(inputVector, subArrayRow, i, numChunkVector, numRowMatrix);
+						SubArrayCalculateChunk(subArray, subArrayInput, subArrayMemory, conductance, evaluation, cell, chunkPerformance);
 						
-						int cellRange = pow(2, param->cellBit);
-						if (param->parallelRead) {
-							subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
-						} else {
-							subArray->levelOutput = cellRange;
+						// accumulate in input vector order, independent of how the chunk was split among threads
+						for (int v=0; v<numChunkVector; v++) {
+							const SubArray::ReadResult &result = chunkPerformance[v];
+							subArrayReadLatency += result.readLatency;
+							*readDynamicEnergy += result.readDynamicEnergy;
+							subArrayLeakage = result.leakage;
+							
+							subArrayLatencyADC += result.readLatencyADC;
+							subArrayLatencyAccum += result.readLatencyAccum;
+							subArrayLatencyOther += result.readLatencyOther;
+							
+							*coreEnergyADC += result.readDynamicEnergyADC;
+							*coreEnergyAccum += result.readDynamicEnergyAccum;
+							*coreEnergyOther += result.readDynamicEnergyOther;
 						}
-						
-						vector<double> columnResistance;
-						columnResistance = GetColumnResistance(input, subArrayMemory, cell, param->parallelRead, subArray->resCellAccess);
-
-						subArray->CalculateLatency(1e20, columnResistance);
-						subArray->CalculatePower(columnResistance);
-						
-						subArrayReadLatency += subArray->readLatency;
-						*readDynamicEnergy += subArray->readDynamicEnergy;
-						subArrayLeakage = subArray->leakage;
-						
-						subArrayLatencyADC += subArray->readLatencyADC;
-						subArrayLatencyAccum += subArray->readLatencyAccum;
-						subArrayLatencyOther += subArray->readLatencyOther;
-						
-						*coreEnergyADC += subArray->readDynamicEnergyADC;
-						*coreEnergyAccum += subArray->readDynamicEnergyAccum;
-						*coreEnergyOther += subArray->readDynamicEnergyOther;
 					}
 					adderTree->CalculateLatency((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray), 0);
 					adderTree->CalculatePower((int)(numInVector/param->numBitInput)*param->numColMuxed, ceil((double) weightMatrixRow/(double) param->numRowSubArray));
@@ -472,122 +528,450 @@ double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vecto
 }
 
 
-vector<vector<double> > CopySubArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numCol; j++) {
-			copyRow.push_back(orginal[positionRow+i][positionCol+j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
+// nonlinear cells read in parallel: the IR drop solver runs per input vector and cellConductance is only its superposition,
+// so the solver is factored once here and kept for the chunks of the subArray
+SubArrayConductance::SubArrayConductance(const MatrixView &weight, MemCell& cell, const EvaluationState &evaluation): solver(NULL) {
+	if (CrossbarSolver::PerVector(cell)) {
+		solver = new CrossbarSolver(weight, cell, evaluation.variation, evaluation.replica);
 	}
-	return copy;
-	copy.clear();
-} 
+	cellConductance = GetCellConductance(weight, cell, &evaluation, solver);
+	if (evaluation.variation) {
+		nominalConductance = GetCellConductance(weight, cell);
+	}
+}
 
+SubArrayConductance::~SubArrayConductance() {
+	delete solver;
+}
 
-vector<vector<double> > CopySubInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numInputVector; j++) {
-			copyRow.push_back(orginal[positionRow+i][j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
+
+// read performance of each input vector of one chunk, result[v] belongs to vector v of subArrayInput;
+// in the sampling mode (param->sampleError > 0) only part of the vectors are simulated, see SubArraySampleChunk,
+// in the fast estimate mode (param->fastEstimate == 1) none of them, see SubArrayEstimateChunk
+void SubArrayCalculateChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const SubArrayConductance &conductance,
+							const EvaluationState &evaluation, MemCell& cell, vector<SubArray::ReadResult> &result) {
+	const vector<double> &cellConductance = conductance.cellConductance;
+	const vector<double> &nominalConductance = conductance.nominalConductance;
+	const CrossbarSolver *solver = conductance.solver;
+	subArray->readCache.clear();
+	subArray->readCacheEnabled = param->readResultCache == 1 || (param->readResultCache == 2 && cell.memCellType == Type::SRAM);
+	int cellRange = pow(2, param->cellBit);
+	if (param->parallelRead) {
+		subArray->levelOutput = param->levelOutput;               // # of levels of the multilevelSenseAmp output
+	} else {
+		subArray->levelOutput = cellRange;
+	}
+	
+	int numVector = subArrayInput.numVector;
+	result.resize(numVector);
+	if (param->fastEstimate == 1) {
+		SubArrayEstimateChunk(subArray, subArrayInput, subArrayMemory, cellConductance, cell, &result[0]);
+		return;
+	}
+	if (param->sampleError > 0) {
+		SubArraySampleChunk(subArray, subArrayInput, subArrayMemory, cellConductance, nominalConductance, solver, evaluation, cell, &result[0]);
+	} else {
+		SubArrayEvaluate(subArray, subArrayInput, NULL, numVector, subArrayMemory, cellConductance, nominalConductance, solver, evaluation, cell, &result[0]);
 	}
-	return copy;
-	copy.clear();
 }
 
 
-vector<double> GetInputVector(const vector<vector<double> > &input, int numInput, double *activityRowRead) {
-	vector<double> copy;
-	for (int i=0; i<input.size(); i++) {
-		double x = input[i][numInput];
-		copy.push_back(x);   
-	}  
-	double numofreadrow = 0;  // initialize readrowactivity parameters
-	for (int i=0; i<input.size(); i++) {
-		if (copy[i] != 0) {
-			numofreadrow += 1;
-		}else {
-			numofreadrow += 0;
-		}
+static void StoreReadResult(const SubArray *subArray, SubArray::ReadResult &r) {
+	r.readLatency = subArray->readLatency;
+	r.readDynamicEnergy = subArray->readDynamicEnergy;
+	r.leakage = subArray->leakage;
+	r.readLatencyADC = subArray->readLatencyADC;
+	r.readLatencyAccum = subArray->readLatencyAccum;
+	r.readLatencyOther = subArray->readLatencyOther;
+	r.readDynamicEnergyADC = subArray->readDynamicEnergyADC;
+	r.readDynamicEnergyAccum = subArray->readDynamicEnergyAccum;
+	r.readDynamicEnergyOther = subArray->readDynamicEnergyOther;
+}
+
+
+// analytical estimate of one chunk: the subArray and its peripheries are evaluated once, for the expected input vector
+// (the activation density of each row over the chunk), and every vector is given that result; the column conductances are
+// linear in the inputs, so the expected conductance of each column is exact, the error comes from the nonlinear models
+void SubArrayEstimateChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const vector<double> &cellConductance, 
+							MemCell& cell, SubArray::ReadResult *result) {
+	ProcessingUnitScratch &buffer = *scratch;
+	subArrayInput.RowDensity(buffer.input);
+	double activity = 0;
+	for (int i=0; i<subArrayInput.numRow; i++) {
+		activity += buffer.input[i];
 	}
-	double totalnumRow = input.size();
-	*(activityRowRead) = numofreadrow/totalnumRow;
-	return copy;
-	copy.clear();
-} 
+	subArray->activityRowRead = activity/subArrayInput.numRow;
+	
+	GetExpectedColumnResistance(buffer.input, cellConductance, subArrayMemory.numRow, subArrayMemory.numCol, cell, param->parallelRead, subArray->resCellAccess, buffer.columnG, buffer.columnResistance);
+	subArray->CalculateReadPerformance(1e20, buffer.columnResistance);
+	
+	StoreReadResult(subArray, result[0]);
+	fill(result+1, result+subArrayInput.numVector, result[0]);
+}
 
 
-vector<double> GetColumnResistance(const vector<double> &input, const vector<vector<double> > &weight, MemCell& cell, bool parallelRead, double resCellAccess) {
-	vector<double> resistance;
-	vector<double> conductance;
-	double columnG = 0; 
+static SubArray::ReadResult zeroResult;
+
+static double SubArray::ReadResult::* const readField[9] = {
+	&SubArray::ReadResult::readLatency, &SubArray::ReadResult::readDynamicEnergy, &SubArray::ReadResult::leakage, 
+	&SubArray::ReadResult::readLatencyADC, &SubArray::ReadResult::readLatencyAccum, &SubArray::ReadResult::readLatencyOther, 
+	&SubArray::ReadResult::readDynamicEnergyADC, &SubArray::ReadResult::readDynamicEnergyAccum, &SubArray::ReadResult::readDynamicEnergyOther
+};
+
+
+// stratified random sampling of the input vectors of one chunk: the vectors are grouped by their # of activated rows (which 
+// drives most of the read cost), each group is sampled with a fixed seed and the samples are doubled until the 95% confidence 
+// interval of every field of the chunk total is within param->sampleError of its estimate (or every vector is simulated);
+// the unsampled vectors get the mean of their group, so the sum over result[] is the stratified estimate of the chunk total
+void SubArraySampleChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const vector<double> &cellConductance, 
+							const vector<double> &nominalConductance, const CrossbarSolver *solver, const EvaluationState &evaluation, MemCell& cell, 
+							SubArray::ReadResult *result) {
+	const int numField = 9;
+	int numVector = subArrayInput.numVector;
+	int numStrata = min(64, subArrayInput.numRow+1);
+	vector<vector<int> > strata(numStrata);
+	for (int v=0; v<numVector; v++) {
+		strata[(long long) subArrayInput.CountActiveRow(v)*numStrata/(subArrayInput.numRow+1)].push_back(v);
+	}
+	mt19937 generator(1);
+	for (int h=0; h<numStrata; h++) {
+		shuffle(strata[h].begin(), strata[h].end(), generator);
+	}
 	
-	for (int j=0; j<weight[0].size(); j++) {
-		int activatedRow = 0;
-		columnG = 0;
-		for (int i=0; i<weight.size(); i++) {
-			if (cell.memCellType == Type::RRAM) {	// eNVM
-				double totalWireResistance;
-				if (cell.accessType == CMOS_access) {
-					totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol + cell.resistanceAccess;
-				} else {
-					totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol;
-				}
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/totalWireResistance;
-					activatedRow += 1 ;
-				} else {
-					columnG += 0;
+	vector<int> numSampled(numStrata, 0);
+	vector<int> index;
+	double relativeError[numField];
+	for (int round=0; ; round++) {
+		index.clear();
+		bool complete = true;
+		for (int h=0; h<numStrata; h++) {
+			int size = strata[h].size();
+			int n = min(size, max(2, (int) ceil(ldexp((double) size, round-10))));	// 1/1024 of each group at first, at least 2 for a variance
+			index.insert(index.end(), strata[h].begin()+numSampled[h], strata[h].begin()+n);
+			numSampled[h] = n;
+			complete = complete && n == size;
+		}
+		vector<SubArray::ReadResult> sample(index.size());
+		if (!index.empty()) {
+			SubArrayEvaluate(subArray, subArrayInput, &index[0], index.size(), subArrayMemory, cellConductance, nominalConductance, solver, evaluation, cell, &sample[0]);
+		}
+		for (int k=0; k<index.size(); k++) {
+			result[index[k]] = sample[k];
+		}
+		
+		bool converged = true;
+		for (int f=0; f<numField; f++) {
+			double total = 0, variance = 0;
+			for (int h=0; h<numStrata; h++) {
+				double size = strata[h].size(), n = numSampled[h];
+				if (n == 0) {
+					continue;
 				}
-			} else if (cell.memCellType == Type::FeFET) {
-				double totalWireResistance;
-				totalWireResistance = (double) 1.0/weight[i][j] + (j + 1) * param->wireResistanceRow + (weight.size() - i) * param->wireResistanceCol;
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/totalWireResistance;
-					activatedRow += 1 ;
-				} else {
-					columnG += 0;
+				double sum = 0, sumSquare = 0;
+				for (int k=0; k<n; k++) {
+					double y = result[strata[h][k]].*readField[f];
+					sum += y;
+					sumSquare += y*y;
 				}
-				
-			} else if (cell.memCellType == Type::SRAM) {	
-				// SRAM: weight value do not affect sense energy --> read energy calculated in subArray.cpp (based on wireRes wireCap etc)
-				if ((int) input[i] == 1) {
-					columnG += (double) 1.0/resCellAccess + (double) 1.0/param->wireResistanceCol;
-					activatedRow += 1 ;
-				} else {
-					columnG += (double) 1.0/param->wireResistanceCol;
+				double mean = sum/n;
+				total += size*mean;
+				if (n > 1 && n < size) {
+					double s2 = max(0.0, (sumSquare - n*mean*mean)/(n-1));
+					variance += size*size*(1-n/size)*s2/n;
 				}
 			}
+			relativeError[f] = total > 0? 1.96*sqrt(variance)/total : 0;
+			converged = converged && relativeError[f] <= param->sampleError;
+		}
+		if (converged || complete) {
+			break;
 		}
+	}
+	
+	long long numSimulated = 0;
+	for (int h=0; h<numStrata; h++) {
+		int n = numSampled[h];
+		numSimulated += n;
+		if (n == strata[h].size()) {
+			continue;
+		}
+		SubArray::ReadResult mean = zeroResult;
+		for (int f=0; f<numField; f++) {
+			for (int k=0; k<n; k++) {
+				mean.*readField[f] += result[strata[h][k]].*readField[f];
+			}
+			mean.*readField[f] /= n;
+		}
+		for (int k=n; k<strata[h].size(); k++) {
+			result[strata[h][k]] = mean;
+		}
+	}
+	SamplingStatistics *statistics = evaluation.sampling;
+	if (statistics) {
+		#pragma omp critical(samplingStatistics)
+		{
+			statistics->numVector += numVector;
+			statistics->numSampled += numSimulated;
+			for (int f=0; f<numField; f++) {
+				statistics->relativeError[f] = max(statistics->relativeError[f], relativeError[f]);
+			}
+		}
+	}
+}
+
+
+// read performance of the input vectors index[0..numIndex) (0..numIndex if index is NULL), result[k] belongs to the k-th of them;
+// with more than one thread the vectors are split into slices evaluated as tasks on private copies of the subArray
+void SubArrayEvaluate(SubArray *subArray, const BitPlane &subArrayInput, const int *index, int numIndex, const MatrixView &subArrayMemory, 
+							const vector<double> &cellConductance, const vector<double> &nominalConductance, const CrossbarSolver *solver, 
+							const EvaluationState &evaluation, MemCell& cell, SubArray::ReadResult *result) {
+	int numSlice = min(omp_get_num_threads(), numIndex);
+	if (numSlice <= 1) {
+		SubArrayCalculateVectors(subArray, *scratch, subArrayInput, index, 0, numIndex, subArrayMemory, cellConductance, nominalConductance, solver, evaluation, cell, result);
+		return;
+	}
+	#pragma omp taskloop default(shared) grainsize(1)
+	for (int s=0; s<numSlice; s++) {
+		SubArray *copy = subArray->Clone();
+		ProcessingUnitScratch buffer;
+		SubArrayCalculateVectors(copy, buffer, subArrayInput, index, (long long) s*numIndex/numSlice, (long long) (s+1)*numIndex/numSlice, 
+								subArrayMemory, cellConductance, nominalConductance, solver, evaluation, cell, result);
+		delete copy;
+	}
+}
+
+
+// solver (nonlinear cells read in parallel, see SubArrayConductance): the column conductances of each input vector come from
+// the nodal solution, CrossbarSolver::BATCH vectors at a time; the read noise and the ADC level errors of the Monte Carlo
+// trials are not modeled on this path (the device variation is, through the solver's cell conductances)
+void SubArrayCalculateVectors(SubArray *subArray, ProcessingUnitScratch &buffer, const BitPlane &subArrayInput, const int *index, int begin, int end, 
+							const MatrixView &subArrayMemory, const vector<double> &cellConductance, const vector<double> &nominalConductance, 
+							const CrossbarSolver *solver, const EvaluationState &evaluation, MemCell& cell, SubArray::ReadResult *result) {
+	MonteCarloStream *variation = evaluation.variation;
+	const vector<double> &Rref = subArray->multilevelSenseAmp.Rref;
+	long long numColumnRead = 0, numLevelError = 0, sumLevelError = 0;
+	int batch[CrossbarSolver::BATCH];
+	for (int k=begin; k<end; k++) {
+		int v = index? index[k] : k;
+		double activityRowRead = 0;
+		GetInputVector(subArrayInput, v, &activityRowRead, buffer.input);
+		subArray->activityRowRead = activityRowRead;
 		
-		if (cell.memCellType == Type::RRAM || cell.memCellType == Type::FeFET) {
-			if (!parallelRead) {  
-				conductance.push_back((double) columnG/activatedRow);
-			} else {
-				conductance.push_back(columnG);
+		if (solver) {
+			int numCol = subArrayMemory.numCol, position = (k-begin) % CrossbarSolver::BATCH;
+			if (position == 0) {
+				int numBatch = min(CrossbarSolver::BATCH, end-k);
+				for (int b=0; b<numBatch; b++) {
+					batch[b] = index? index[k+b] : k+b;
+				}
+				buffer.solvedG.resize(CrossbarSolver::BATCH*numCol);
+				if (!solver->ColumnConductance(subArrayInput, batch, numBatch, &buffer.solvedG[0])) {
+					cerr << "Error: the IR drop solver did not converge for the input vectors of a subArray!" << endl;
+					exit(-1);
+				}
+			}
+			buffer.columnG.assign(buffer.solvedG.begin() + position*numCol, buffer.solvedG.begin() + (position+1)*numCol);
+			buffer.columnResistance.resize(numCol);
+			ConvertColumnResistance(buffer.columnG, subArrayInput.CountActiveRow(v), cell, param->parallelRead, buffer.columnResistance);
+		} else if (variation && cell.memCellType != Type::SRAM) {
+			GetNoisyColumnResistance(buffer.input, cellConductance, subArrayMemory, subArrayInput.firstVector+v, evaluation, cell, param->parallelRead, 
+									subArray->resCellAccess, buffer.columnG, buffer.columnVariance, buffer.columnResistance);
+			if (!Rref.empty()) {
+				// output levels of the multilevel sense amp against the nominal devices without read noise
+				GetColumnResistance(buffer.input, nominalConductance, subArrayMemory.numRow, subArrayMemory.numCol, cell, param->parallelRead, subArray->resCellAccess, buffer.nominalG, buffer.nominalResistance);
+				for (int j=0; j<subArrayMemory.numCol; j++) {
+					int error = abs(subArray->multilevelSenseAmp.GetColumnLevel(buffer.columnResistance[j]) - subArray->multilevelSenseAmp.GetColumnLevel(buffer.nominalResistance[j]));
+					numLevelError += error > 0;
+					sumLevelError += error;
+				}
+				numColumnRead += subArrayMemory.numCol;
 			}
 		} else {
-			conductance.push_back(columnG);
+			GetColumnResistance(buffer.input, cellConductance, subArrayMemory.numRow, subArrayMemory.numCol, cell, param->parallelRead, subArray->resCellAccess, buffer.columnG, buffer.columnResistance);
 		}
+		subArray->CalculateReadPerformance(1e20, buffer.columnResistance);
+		
+		StoreReadResult(subArray, result[k]);
 	}
-	// covert conductance to resistance
-	for (int i=0; i<weight[0].size(); i++) {
-		resistance.push_back((double) 1.0/conductance[i]);
+	if (numColumnRead) {
+		#pragma omp atomic
+		variation->numColumnRead += numColumnRead;
+		#pragma omp atomic
+		variation->numLevelError += numLevelError;
+		#pragma omp atomic
+		variation->sumLevelError += sumLevelError;
 	}
-		
-	return resistance;
-	resistance.clear();
+}
+
+
+BitPlane CopySubInput(const BitPlane &orginal, int positionRow, int positionVector, int numInputVector, int numRow) {
+	BitPlane copy;
+	copy.Initialize(numRow, numInputVector);
+	copy.CopyRows(orginal, positionRow, numRow, 0, positionVector);
+	copy.firstVector = orginal.firstVector + positionVector;
+	return copy;
+}
+
+
+void GetInputVector(const BitPlane &input, int numInput, double *activityRowRead, vector<double> &copy) {
+	copy.resize(input.numRow);
+	for (int i=0; i<input.numRow; i++) {
+		copy[i] = input.GetBit(i, numInput);
+	}
+	double numofreadrow = input.CountActiveRow(numInput);  // rows activated by this input vector
+	double totalnumRow = input.numRow;
+	*(activityRowRead) = numofreadrow/totalnumRow;
 } 
 
 
+// conductance of each cell including its wire (and access) resistance, only depends on the weights --> computed once per subArray;
+// with the IR drop solver the effective conductance of each cell with only its row driven (see CrossbarSolver), from solver
+// when the caller already built the one of this subArray; evaluation: the devices of a Monte Carlo trial, NULL: nominal devices
+vector<double> GetCellConductance(const MatrixView &weight, MemCell& cell, const EvaluationState *evaluation, const CrossbarSolver *solver) {
+	MonteCarloStream *variation = evaluation? evaluation->variation : NULL;
+	int replica = evaluation? evaluation->replica : 0;
+	vector<double> conductance;
+	if (cell.memCellType == Type::SRAM) {
+		// SRAM: weight value do not affect sense energy, nothing to precompute
+		return conductance;
+	}
+	if (CrossbarSolver::Enabled(cell)) {
+		bool converged = solver? solver->TransferConductance(conductance) : CrossbarSolver(weight, cell, variation, replica).TransferConductance(conductance);
+		if (!converged) {
+			cerr << "Error: the IR drop solver did not converge for the cell conductances of a subArray!" << endl;
+			exit(-1);
+		}
+		return conductance;
+	}
+	conductance.resize((size_t) weight.numRow*weight.numCol);
+	for (int i=0; i<weight.numRow; i++) {
+		const uint8_t *w = weight.Row(i);
+		double *g = &conductance[(size_t) i*weight.numCol];
+		for (int j=0; j<weight.numCol; j++) {
+			double totalWireResistance;
+			double cellConductance = weight.conductance[w[j]];
+			if (variation) {
+				cellConductance = MonteCarloCellConductance(*variation, MonteCarloCellOf(replica, w + j - weight.origin), cellConductance);
+			}
+			if (cell.memCellType == Type::RRAM && cell.accessType == CMOS_access) {
+				totalWireResistance = (double) 1.0/cellConductance + (j + 1) * param->wireResistanceRow + (weight.numRow - i) * param->wireResistanceCol + cell.resistanceAccess;
+			} else {
+				totalWireResistance = (double) 1.0/cellConductance + (j + 1) * param->wireResistanceRow + (weight.numRow - i) * param->wireResistanceCol;
+			}
+			g[j] = (double) 1.0/totalWireResistance;
+		}
+	}
+	return conductance;
+}
+
+
+// covert conductance to resistance (RRAM/FeFET without parallel read: the average of the activated rows)
+static void ConvertColumnResistance(const vector<double> &columnG, double activatedRow, MemCell& cell, bool parallelRead, vector<double> &resistance) {
+	for (int j=0; j<columnG.size(); j++) {
+		if ((cell.memCellType == Type::RRAM || cell.memCellType == Type::FeFET) && !parallelRead) {
+			resistance[j] = (double) 1.0/((double) columnG[j]/activatedRow);
+		} else {
+			resistance[j] = (double) 1.0/columnG[j];
+		}
+	}
+}
 
 
+// columnG and resistance are caller-owned scratch buffers, reused across input vectors
+void GetColumnResistance(const vector<double> &input, const vector<double> &cellConductance, int numRow, int numCol, MemCell& cell, bool parallelRead, double resCellAccess, 
+						vector<double> &columnG, vector<double> &resistance) {
+	resistance.resize(numCol);
+	columnG.assign(numCol, 0);
+	int activatedRow = 0;
+	
+	if (cell.memCellType == Type::SRAM) {	
+		// SRAM: weight value do not affect sense energy --> read energy calculated in subArray.cpp (based on wireRes wireCap etc)
+		// every column sees the same sum, accumulate it once (same order of additions) and broadcast
+		double sumG = 0;
+		for (int i=0; i<numRow; i++) {
+			if ((int) input[i] == 1) {
+				sumG += (double) 1.0/resCellAccess + (double) 1.0/param->wireResistanceCol;
+				activatedRow += 1 ;
+			} else {
+				sumG += (double) 1.0/param->wireResistanceCol;
+			}
+		}
+		columnG.assign(numCol, sumG);
+	} else {	// eNVM
+		// accumulate row by row over the contiguous row-major conductances so that the inner loop streams one row,
+		// rows that are not activated do not contribute and are skipped
+		double *sum = &columnG[0];
+		for (int i=0; i<numRow; i++) {
+			if ((int) input[i] == 1) {
+				const double *g = &cellConductance[(size_t) i*numCol];
+				for (int j=0; j<numCol; j++) {
+					sum[j] += g[j];
+				}
+				activatedRow += 1 ;
+			}
+		}
+	}
+	
+	ConvertColumnResistance(columnG, activatedRow, cell, parallelRead, resistance);
+} 
+
 
+// expected column resistances for input rows activated with the probabilities in density (see GetColumnResistance)
+void GetExpectedColumnResistance(const vector<double> &density, const vector<double> &cellConductance, int numRow, int numCol, MemCell& cell, bool parallelRead, 
+						double resCellAccess, vector<double> &columnG, vector<double> &resistance) {
+	resistance.resize(numCol);
+	columnG.assign(numCol, 0);
+	double activatedRow = 0;
+	
+	if (cell.memCellType == Type::SRAM) {
+		double sumG = 0;
+		for (int i=0; i<numRow; i++) {
+			sumG += density[i]/resCellAccess + (double) 1.0/param->wireResistanceCol;
+			activatedRow += density[i];
+		}
+		columnG.assign(numCol, sumG);
+	} else {	// eNVM
+		double *sum = &columnG[0];
+		for (int i=0; i<numRow; i++) {
+			if (density[i] > 0) {
+				const double *g = &cellConductance[(size_t) i*numCol];
+				for (int j=0; j<numCol; j++) {
+					sum[j] += density[i]*g[j];
+				}
+				activatedRow += density[i];
+			}
+		}
+	}
+	
+	ConvertColumnResistance(columnG, activatedRow, cell, parallelRead, resistance);
+}
 
 
+// column resistances of an eNVM subArray in a Monte Carlo trial: every activated cell adds a gaussian read noise of relative
+// sigma param->readNoise to its conductance, drawn per column as one gaussian of the summed variance; the draws are keyed by
+// the first cell of the column and the position of the input vector in the layer
+void GetNoisyColumnResistance(const vector<double> &input, const vector<double> &cellConductance, const MatrixView &weight, uint64_t inputIndex, 
+						const EvaluationState &evaluation, MemCell& cell, bool parallelRead, double resCellAccess, vector<double> &columnG, vector<double> &variance, vector<double> &resistance) {
+	int numRow = weight.numRow, numCol = weight.numCol;
+	resistance.resize(numCol);
+	columnG.assign(numCol, 0);
+	variance.assign(numCol, 0);
+	int activatedRow = 0;
+	double *sum = &columnG[0], *sumSquare = &variance[0];
+	for (int i=0; i<numRow; i++) {
+		if ((int) input[i] == 1) {
+			const double *g = &cellConductance[(size_t) i*numCol];
+			for (int j=0; j<numCol; j++) {
+				sum[j] += g[j];
+				sumSquare[j] += g[j]*g[j];
+			}
+			activatedRow += 1 ;
+		}
+	}
+	if (param->readNoise > 0) {
+		for (int j=0; j<numCol; j++) {
+			sum[j] = max(0.0, sum[j] + param->readNoise*sqrt(sumSquare[j])*MonteCarloReadNoise(*evaluation.variation, MonteCarloCellOf(evaluation.replica, weight.CellIndex(0, j)), inputIndex));
+		}
+	}
+	ConvertColumnResistance(columnG, activatedRow, cell, parallelRead, resistance);
+}
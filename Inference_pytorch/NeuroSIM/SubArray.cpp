@@ -46,6 +46,9 @@
 
 using namespace std;
 
+long long SubArray::totalReadCacheHit = 0;
+long long SubArray::totalReadCacheMiss = 0;
+
 SubArray::SubArray(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell):
 						inputParameter(_inputParameter), tech(_tech), cell(_cell),
 						wlDecoder(_inputParameter, _tech, _cell),
@@ -73,6 +76,38 @@ SubArray::SubArray(InputParameter& _inputParameter, Technology& _tech, MemCell&
 						multilevelSAEncoder(_inputParameter, _tech, _cell){
 	initialized = false;
 	readDynamicEnergyArray = writeDynamicEnergyArray = 0;
+
+	// options that ProcessingUnitInitialize does not set, keep them at their defaults
+	// (otherwise Initialize reads whatever was left in the heap block)
+	activityRowRead = activityRowWrite = activityColWrite = 0;
+	maxNumIntBit = 0;
+	neuroSimReadSimulation = false;
+	readCircuitMode = CMOS;
+	FPGA = false;
+	LUT_dynamic = false;
+	backToBack = false;
+	numLut = 0;
+	numReadLutPerOperationFPGA = 0;
+	spikingMode = NONSPIKING;
+	shiftAddEnable = false;
+	
+	readCacheEnabled = false;
+	numReadCacheHit = numReadCacheMiss = 0;
+}
+
+SubArray::~SubArray() {
+	#pragma omp atomic
+	totalReadCacheHit += numReadCacheHit;
+	#pragma omp atomic
+	totalReadCacheMiss += numReadCacheMiss;
+}
+
+// copy of an initialized subArray that can be evaluated independently, it starts with an empty result cache
+SubArray *SubArray::Clone() const {
+	SubArray *copy = new SubArray(*this);
+	copy->readCache.clear();
+	copy->numReadCacheHit = copy->numReadCacheMiss = 0;
+	return copy;
 }
 
 void SubArray::Initialize(int _numRow, int _numCol, double _unitWireRes){  //initialization module
@@ -80,6 +115,7 @@ void SubArray::Initialize(int _numRow, int _numCol, double _unitWireRes){  //ini
 	numRow = _numRow;    //import parameters
 	numCol = _numCol;
 	unitWireRes = _unitWireRes;
+	readCache.clear();
 	
 	double MIN_CELL_HEIGHT = MAX_TRANSISTOR_HEIGHT;  //set real layout cell height
 	double MIN_CELL_WIDTH = (MIN_GAP_BET_GATE_POLY + POLY_WIDTH) * 2;  //set real layout cell width
@@ -322,6 +358,7 @@ void SubArray::CalculateArea() {  //calculate layout area for total design
 	if (!initialized) {
 		cout << "[Subarray] Error: Require initialization first!" << endl;  //ensure initialization first
 	} else {  //if initialized, start to do calculation
+		readCache.clear();
 		area = 0;
 		usedArea = 0;
 		if (cell.memCellType == Type::SRAM) {       
@@ -1445,6 +1482,54 @@ void SubArray::CalculatePower(const vector<double> &columnResistance) {
 	}
 }
 
+void SubArray::CalculateReadPerformance(double _rampInput, const vector<double> &columnResistance) {
+	if (!readCacheEnabled) {
+		CalculateLatency(_rampInput, columnResistance);
+		CalculatePower(columnResistance);
+		return;
+	}
+	
+	// the results only depend on the row activity, the output levels and the column resistances,
+	// input vectors that repeat them (e.g. sparse activations) are served from the cache
+	double head[5] = {_rampInput, activityRowRead, activityRowWrite, activityColWrite, (double) levelOutput};
+	readKey.assign((const char *) head, sizeof(head));
+	if (!columnResistance.empty()) {
+		readKey.append((const char *) &columnResistance[0], columnResistance.size()*sizeof(double));
+	}
+	
+	unordered_map<string, ReadResult>::const_iterator it = readCache.find(readKey);
+	if (it != readCache.end()) {
+		const ReadResult &result = it->second;
+		readLatency = result.readLatency;
+		readDynamicEnergy = result.readDynamicEnergy;
+		leakage = result.leakage;
+		readLatencyADC = result.readLatencyADC;
+		readLatencyAccum = result.readLatencyAccum;
+		readLatencyOther = result.readLatencyOther;
+		readDynamicEnergyADC = result.readDynamicEnergyADC;
+		readDynamicEnergyAccum = result.readDynamicEnergyAccum;
+		readDynamicEnergyOther = result.readDynamicEnergyOther;
+		numReadCacheHit++;
+		return;
+	}
+	
+	CalculateLatency(_rampInput, columnResistance);
+	CalculatePower(columnResistance);
+	numReadCacheMiss++;
+	
+	ReadResult result;
+	result.readLatency = readLatency;
+	result.readDynamicEnergy = readDynamicEnergy;
+	result.leakage = leakage;
+	result.readLatencyADC = readLatencyADC;
+	result.readLatencyAccum = readLatencyAccum;
+	result.readLatencyOther = readLatencyOther;
+	result.readDynamicEnergyADC = readDynamicEnergyADC;
+	result.readDynamicEnergyAccum = readDynamicEnergyAccum;
+	result.readDynamicEnergyOther = readDynamicEnergyOther;
+	readCache[readKey] = result;
+}
+
 void SubArray::PrintProperty() {
 
 	if (cell.memCellType == Type::SRAM) {
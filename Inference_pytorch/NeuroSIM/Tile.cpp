@@ -66,6 +66,56 @@ HTree *hTree;
 AdderTree *accumulation;
 Sigmoid *sigmoid;
 BitShifter *reLu;
+#pragma omp threadprivate(subArrayInPE, inputBuffer, outputBuffer, hTree, accumulation, sigmoid, reLu)
+
+TileContext TileSaveContext() {
+	TileContext context;
+	context.subArrayInPE = subArrayInPE;
+	context.inputBuffer = inputBuffer;
+	context.outputBuffer = outputBuffer;
+	context.hTree = hTree;
+	context.accumulation = accumulation;
+	context.sigmoid = sigmoid;
+	context.reLu = reLu;
+	context.pe = ProcessingUnitSaveContext();
+	return context;
+}
+
+void TileLoadContext(const TileContext &context) {
+	subArrayInPE = context.subArrayInPE;
+	inputBuffer = context.inputBuffer;
+	outputBuffer = context.outputBuffer;
+	hTree = context.hTree;
+	accumulation = context.accumulation;
+	sigmoid = context.sigmoid;
+	reLu = context.reLu;
+	ProcessingUnitLoadContext(context.pe);
+}
+
+TileContext TileCloneContext(const TileContext &context) {
+	TileContext copy;
+	copy.subArrayInPE = context.subArrayInPE? context.subArrayInPE->Clone() : NULL;
+	copy.inputBuffer = context.inputBuffer? new Buffer(*context.inputBuffer) : NULL;
+	copy.outputBuffer = context.outputBuffer? new Buffer(*context.outputBuffer) : NULL;
+	copy.hTree = context.hTree? new HTree(*context.hTree) : NULL;
+	copy.accumulation = context.accumulation? new AdderTree(*context.accumulation) : NULL;
+	copy.sigmoid = context.sigmoid? new Sigmoid(*context.sigmoid) : NULL;
+	copy.reLu = context.reLu? new BitShifter(*context.reLu) : NULL;
+	copy.pe = ProcessingUnitCloneContext(context.pe);
+	return copy;
+}
+
+void TileFreeContext(TileContext &context) {
+	delete context.subArrayInPE;
+	delete context.inputBuffer;
+	delete context.outputBuffer;
+	delete context.hTree;
+	delete context.accumulation;
+	delete context.sigmoid;
+	delete context.reLu;
+	ProcessingUnitFreeContext(context.pe);
+	context = TileContext();
+}
 
 
 void TileInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, double _numPE, double _peSize){
@@ -181,10 +231,11 @@ vector<double> TileCalculateArea(double numPE, double peSize, double *height, do
 }
 
 
-void TileCalculatePerformance(const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, const vector<vector<double> > &inputVector, int novelMap, double numPE, 
+void TileCalculatePerformance(const MatrixView &newMemory, const MatrixView &oldMemory, const BitPlane &inputVector, int novelMap, double numPE, 
 							double peSize, int speedUpRow, int speedUpCol, int weightMatrixRow, int weightMatrixCol, int numInVector, MemCell& cell, double *readLatency, double *readDynamicEnergy, double *leakage,
 							double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
-							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther) {
+							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther,
+							const EvaluationState &evaluation) {
 
 	/*** sweep PE ***/
 	int numRowPerSynapse, numColPerSynapse;
@@ -214,15 +265,15 @@ void TileCalculatePerformance(const vector<vector<double> > &newMemory, const ve
 			if ( (speedUpRow >= ceil(sqrt((double)numPE))) && (speedUpCol >= ceil(sqrt((double)numPE))) ) {
 				// duplication in PE or subArray --> tell each PE to take the whole assigned weight  --> "fully" duplication
 				// assign weight and input to specific tile
-				vector<vector<double> > pEMemory;
-				pEMemory = CopyPEArray(newMemory, 0, 0, weightMatrixRow, weightMatrixCol);
-				vector<vector<double> > pEInput;
+				MatrixView pEMemory;
+				pEMemory = newMemory.Block(0, 0, weightMatrixRow, weightMatrixCol);
+				BitPlane pEInput;
 				pEInput = CopyPEInput(inputVector, 0, numInVector, weightMatrixRow);
 				
 				ProcessingUnitCalculatePerformance(subArrayInPE, pEMemory, pEMemory, pEInput, ceil((double)speedUpRow/sqrt((double)numPE)), ceil((double)speedUpCol/sqrt((double)numPE)), 
 											numSubArrayRow, numSubArrayCol, weightMatrixRow, weightMatrixCol, numInVector, cell, &PEreadLatency, &PEreadDynamicEnergy, &PEleakage,
 											&PEbufferLatency, &PEbufferDynamicEnergy, &PEicLatency, &PEicDynamicEnergy,
-											&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther);
+											&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther, evaluation);
 				
 				*readLatency = PEreadLatency/numPE;  // further speed up in PE level
 				*readDynamicEnergy = PEreadDynamicEnergy;   // since subArray.cpp takes all input vectors, no need to *numPE here
@@ -249,15 +300,15 @@ void TileCalculatePerformance(const vector<vector<double> > &newMemory, const ve
 							int numColMatrix = min(peSize, (double) weightMatrixCol-j*peSize);
 					
 							// assign weight and input to specific tile
-							vector<vector<double> > pEMemory;
-							pEMemory = CopyPEArray(newMemory, i*peSize, j*peSize, numRowMatrix, numColMatrix);
-							vector<vector<double> > pEInput;
+							MatrixView pEMemory;
+							pEMemory = newMemory.Block(i*peSize, j*peSize, numRowMatrix, numColMatrix);
+							BitPlane pEInput;
 							pEInput = CopyPEInput(inputVector, i*peSize, numInVector, numRowMatrix);
 							
 							ProcessingUnitCalculatePerformance(subArrayInPE, pEMemory, pEMemory, pEInput, ceil((double)speedUpRow/sqrt((double)numPE)), ceil((double)speedUpCol/sqrt((double)numPE)), 
 												numSubArrayRow, numSubArrayCol, numRowMatrix, numColMatrix, numInVector, cell, &PEreadLatency, &PEreadDynamicEnergy, &PEleakage,
 												&PEbufferLatency, &PEbufferDynamicEnergy, &PEicLatency, &PEicDynamicEnergy,
-												&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther);
+												&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther, evaluation);
 					
 							*readLatency = max(PEreadLatency, (*readLatency));
 							*readDynamicEnergy += PEreadDynamicEnergy;
@@ -303,15 +354,15 @@ void TileCalculatePerformance(const vector<vector<double> > &newMemory, const ve
 						int numRowMatrix = min(peSize, (double) weightMatrixRow-i*peSize);
 						int numColMatrix = min(peSize, (double) weightMatrixCol-j*peSize);
 						
-						vector<vector<double> > pEMemory;
-						pEMemory = CopyPEArray(newMemory, i*peSize, j*peSize, numRowMatrix, numColMatrix);
-						vector<vector<double> > pEInput;
+						MatrixView pEMemory;
+						pEMemory = newMemory.Block(i*peSize, j*peSize, numRowMatrix, numColMatrix);
+						BitPlane pEInput;
 						pEInput = CopyPEInput(inputVector, i*peSize, numInVector, numRowMatrix);
 							
 						ProcessingUnitCalculatePerformance(subArrayInPE, pEMemory, pEMemory, pEInput, 1, 1, numSubArrayRow, numSubArrayCol, numRowMatrix,
 												numColMatrix, numInVector, cell, &PEreadLatency, &PEreadDynamicEnergy, &PEleakage,
 												&PEbufferLatency, &PEbufferDynamicEnergy, &PEicLatency, &PEicDynamicEnergy,
-												&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther);
+												&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther, evaluation);
 					}
 					*readLatency = max(PEreadLatency, (*readLatency));
 					*readDynamicEnergy += PEreadDynamicEnergy;
@@ -390,15 +441,15 @@ void TileCalculatePerformance(const vector<vector<double> > &newMemory, const ve
 	} else {  // novel Mapping
 		for (int i=0; i<numPE; i++) {
 			if (i*peSize < weightMatrixRow) {
-				vector<vector<double> > pEMemory;
-				pEMemory = CopyPEArray(newMemory, i*peSize, 0, weightMatrixRow/numPE, weightMatrixCol);
-				vector<vector<double> > pEInput;
+				MatrixView pEMemory;
+				pEMemory = newMemory.Block(i*peSize, 0, weightMatrixRow/numPE, weightMatrixCol);
+				BitPlane pEInput;
 				pEInput = CopyPEInput(inputVector, i*peSize, numInVector, weightMatrixRow/numPE);
 					
 				ProcessingUnitCalculatePerformance(subArrayInPE, pEMemory, pEMemory, pEInput, 1, 1, numSubArrayRow, numSubArrayCol, weightMatrixRow/numPE,
 										weightMatrixCol, numInVector, cell, &PEreadLatency, &PEreadDynamicEnergy, &PEleakage,
 										&PEbufferLatency, &PEbufferDynamicEnergy, &PEicLatency, &PEicDynamicEnergy, 
-										&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther);
+										&peLatencyADC, &peLatencyAccum, &peLatencyOther, &peEnergyADC, &peEnergyAccum, &peEnergyOther, evaluation);
 			}
 			*readLatency = max(PEreadLatency, (*readLatency));
 			*readDynamicEnergy += PEreadDynamicEnergy;
@@ -492,32 +543,10 @@ void TileCalculatePerformance(const vector<vector<double> > &newMemory, const ve
 }
 
 
-vector<vector<double> > CopyPEArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numCol; j++) {
-			copyRow.push_back(orginal[positionRow+i][positionCol+j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
-	}
-	return copy;
-	copy.clear();
-} 
-
-
-vector<vector<double> > CopyPEInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow) {
-	vector<vector<double> > copy;
-	for (int i=0; i<numRow; i++) {
-		vector<double> copyRow;
-		for (int j=0; j<numInputVector; j++) {
-			copyRow.push_back(orginal[positionRow+i][j]);
-		}
-		copy.push_back(copyRow);
-		copyRow.clear();
-	}
+BitPlane CopyPEInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow) {
+	BitPlane copy;
+	copy.Initialize(numRow, numInputVector);
+	copy.CopyRows(orginal, positionRow, numRow, 0);
 	return copy;
-	copy.clear();
 }
 
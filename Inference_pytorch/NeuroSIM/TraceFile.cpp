@@ -0,0 +1,133 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "TraceFile.h"
+
+using namespace std;
+
+TraceFile::TraceFile(): data(NULL), mapping(NULL), mapSize(0) {
+	memset(&header, 0, sizeof(header));
+}
+
+TraceFile::~TraceFile() {
+	Close();
+}
+
+bool TraceFile::IsBinaryTrace(const string &filename) {
+	char magic[4];
+	FILE *fp = fopen(filename.c_str(), "rb");
+	if (!fp) {
+		return false;
+	}
+	bool isBinary = (fread(magic, 1, 4, fp) == 4 && memcmp(magic, TRACE_MAGIC, 4) == 0);
+	fclose(fp);
+	return isBinary;
+}
+
+bool TraceFile::Open(const string &filename) {
+	Close();
+	if (!IsBinaryTrace(filename)) {
+		return false;
+	}
+	
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		cerr << "Error: the trace file " << filename << " cannot be opened!" << endl;
+		exit(-1);
+	}
+	if ((size_t)st.st_size < TRACE_HEADER_SIZE) {
+		cerr << "Error: the trace file " << filename << " is truncated!" << endl;
+		exit(-1);
+	}
+	mapSize = st.st_size;
+	mapping = mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	// the mapping stays valid after the descriptor is closed
+	if (mapping == MAP_FAILED) {
+		mapping = NULL;
+		cerr << "Error: the trace file " << filename << " cannot be mapped!" << endl;
+		exit(-1);
+	}
+	madvise(mapping, mapSize, MADV_SEQUENTIAL);
+	memcpy(&header, mapping, sizeof(header));
+	
+	if (header.version != TRACE_VERSION) {
+		cerr << "Error: unsupported trace version " << header.version << " in " << filename << endl;
+		exit(-1);
+	}
+	size_t elementSize;
+	switch (header.dtype) {
+		case TRACE_FLOAT32:	elementSize = sizeof(float); break;
+		case TRACE_FLOAT64:	elementSize = sizeof(double); break;
+		case TRACE_UINT8:	elementSize = sizeof(uint8_t); break;
+		case TRACE_INT8:	elementSize = sizeof(int8_t); break;
+		default:
+			cerr << "Error: unknown trace data type " << header.dtype << " in " << filename << endl;
+			exit(-1);
+	}
+	if (header.numRow > INT_MAX || header.numCol > INT_MAX) {	// the loaders index the matrix with int
+		cerr << "Error: the trace matrix " << header.numRow << "x" << header.numCol << " in " << filename << " is too large!" << endl;
+		exit(-1);
+	}
+	// compared by division, the byte count of a corrupt header could wrap around
+	if (header.dataOffset < TRACE_HEADER_SIZE || header.dataOffset % elementSize != 0 || header.dataOffset > mapSize
+			|| (header.numCol != 0 && header.numRow > (mapSize - header.dataOffset)/elementSize/header.numCol)) {
+		cerr << "Error: the trace file " << filename << " is truncated!" << endl;
+		exit(-1);
+	}
+	data = (const char *)mapping + header.dataOffset;
+	return true;
+}
+
+void TraceFile::Close() {
+	if (mapping) {
+		munmap(mapping, mapSize);
+	}
+	mapping = NULL;
+	data = NULL;
+	mapSize = 0;
+}
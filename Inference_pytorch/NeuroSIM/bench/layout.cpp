@@ -0,0 +1,153 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+// Microbenchmark of the weight layout of the column resistance kernel, built with "make bench":
+//
+//   bench/layout
+//
+// times GetColumnResistance on eNVM subArrays of 64x64, 128x128 and 256x256 cells, over the contiguous row-major
+// conductances it reads now, against the same accumulation over a contiguous column-major buffer and over the
+// vector<vector<double> > rows that it walked column by column before; every input vector flips one input bit
+
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "../constant.h"
+#include "../formula.h"
+#include "../Param.h"
+#include "../Tile.h"
+#include "../Chip.h"
+#include "../ProcessingUnit.h"
+#include "../SubArray.h"
+#include "../NeuroSim.h"
+#include "../Definition.h"
+
+using namespace std;
+
+// as GetColumnResistance with parallelRead, one column at a time down the rows of a vector<vector<double> >
+static void ColumnResistanceRows(const vector<double> &input, const vector<vector<double> > &cellConductance, int numRow, int numCol, vector<double> &resistance) {
+	for (int j=0; j<numCol; j++) {
+		double columnG = 0;
+		for (int i=0; i<numRow; i++) {
+			if ((int) input[i] == 1) {
+				columnG += cellConductance[i][j];
+			}
+		}
+		resistance[j] = (double) 1.0/columnG;
+	}
+}
+
+// the same over a contiguous column-major buffer, each column streams its numRow conductances
+static void ColumnResistanceColumnMajor(const vector<double> &input, const vector<double> &cellConductance, int numRow, int numCol, vector<double> &resistance) {
+	for (int j=0; j<numCol; j++) {
+		const double *g = &cellConductance[(size_t) j*numRow];
+		double columnG = 0;
+		for (int i=0; i<numRow; i++) {
+			if ((int) input[i] == 1) {
+				columnG += g[i];
+			}
+		}
+		resistance[j] = (double) 1.0/columnG;
+	}
+}
+
+int main() {
+	
+	cell.memCellType = Type::RRAM;
+	gen.seed(0);
+	uniform_real_distribution<double> conductance(param->minConductance, param->maxConductance);
+	
+	int size[] = {64, 128, 256};
+	for (int s=0; s<3; s++) {
+		int n = size[s];
+		int numVector = 200000000/(n*n);
+		
+		vector<vector<double> > rows(n, vector<double>(n));
+		vector<double> rowMajor((size_t) n*n), columnMajor((size_t) n*n);
+		for (int i=0; i<n; i++) {
+			for (int j=0; j<n; j++) {
+				rows[i][j] = rowMajor[(size_t) i*n+j] = columnMajor[(size_t) j*n+i] = conductance(gen);
+			}
+		}
+		vector<double> input(n);
+		for (int i=0; i<n; i++) {
+			input[i] = gen() % 2;
+		}
+		input[0] = 1;	// no column without an activated row
+		
+		vector<double> columnG, resistance(n), reference(n), check(n);
+		double time[3];
+		double sum = 0;
+		for (int layout=0; layout<3; layout++) {
+			vector<double> in = input;
+			auto start = chrono::high_resolution_clock::now();
+			for (int v=0; v<numVector; v++) {
+				if (layout == 0) {
+					ColumnResistanceRows(in, rows, n, n, resistance);
+				} else if (layout == 1) {
+					GetColumnResistance(in, rowMajor, n, n, cell, true, 0, columnG, resistance);
+				} else {
+					ColumnResistanceColumnMajor(in, columnMajor, n, n, resistance);
+				}
+				sum += resistance[v % n];
+				int flip = 1 + v % (n-1);
+				in[flip] = 1 - in[flip];
+			}
+			auto end = chrono::high_resolution_clock::now();
+			time[layout] = chrono::duration<double, micro>(end-start).count()/numVector;
+		}
+		
+		ColumnResistanceRows(input, rows, n, n, reference);
+		GetColumnResistance(input, rowMajor, n, n, cell, true, 0, columnG, resistance);
+		ColumnResistanceColumnMajor(input, columnMajor, n, n, check);
+		for (int j=0; j<n; j++) {
+			if (fabs(resistance[j]-reference[j]) > 1e-9*reference[j] || fabs(check[j]-reference[j]) > 1e-9*reference[j]) {
+				cerr << "Error: the layouts give different column resistances at " << n << "x" << n << "!" << endl;
+				return -1;
+			}
+		}
+		cout << n << "x" << n << " (" << numVector << " input vectors, checksum " << sum << "): vector<vector> " << time[0] << " us, row-major "
+			 << time[1] << " us, column-major " << time[2] << " us per input vector" << endl;
+	}
+	
+	return 0;
+}
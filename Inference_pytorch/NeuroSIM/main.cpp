@@ -54,307 +54,162 @@
 #include "Chip.h"
 #include "ProcessingUnit.h"
 #include "SubArray.h"
+#include "NeuroSim.h"
+#include "LayerCache.h"
+#include "MonteCarlo.h"
 #include "Definition.h"
 
 using namespace std;
 
-vector<vector<double> > getNetStructure(const string &inputfile);
-
-int main(int argc, char * argv[]) {   
-
-	auto start = chrono::high_resolution_clock::now();
+// evaluate the layers concurrently, each one on its own copy of the circuit modules
+// (results are gathered per layer and reported in order by the caller, so the output does not depend on the schedule)
+// layers are tasks so that the tile tasks spawned inside ChipCalculatePerformance share the same thread team;
+// a thread may pick up another task while waiting for its tiles, hence every task restores the modules it found
+// with --cache dir, layers whose traces and settings are unchanged since an earlier run are loaded from the cache instead
+static void CalculateLayers(const ChipDesign &design, char *argv[], vector<LayerPerformance> &layerPerformance, vector<int> &layerCached) {
+	int numLayer = design.netStructure.size();
+	bool useLayerCache = !param->layerCacheDir.empty();
+	
+	#pragma omp parallel
+	#pragma omp single
+	for (int i=0; i<numLayer; i++) {
+		#pragma omp task default(shared) firstprivate(i)
+		{
+			uint64_t key = 0;
+			if (useLayerCache) {
+				key = LayerCacheKey(design, i, argv[2*i+4], argv[2*i+5]);
+				layerCached[i] = LayerCacheLoad(param->layerCacheDir, key, &layerPerformance[i]);
+			}
+			if (!layerCached[i]) {
+				// load in whole file 
+				BitPlane inputVector;
+				inputVector = LoadInInputData(argv[2*i+5]); 
+				WeightMatrix newMemory;
+				newMemory = LoadInWeightData(argv[2*i+4], param->numRowPerSynapse, param->numColPerSynapse, param->maxConductance, param->minConductance);
+				
+				NeuroSimCalculateLayer(design, i, newMemory, inputVector, &layerPerformance[i]);
+				if (useLayerCache) {
+					LayerCacheStore(param->layerCacheDir, key, layerPerformance[i]);
+				}
+			}
+		}
+	}
+}
 
-	gen.seed(0);
-	
-	vector<vector<double> > netStructure;
-	netStructure = getNetStructure(argv[1]);
 
-	// define weight/input/memory precision from wrapper
-	param->synapseBit = atoi(argv[2]);              // precision of synapse weight
-	param->numBitInput = atoi(argv[3]);             // precision of input neural activation
-	if (param->cellBit > param->synapseBit) {
-		cout << "ERROR!: Memory precision is even higher than synapse precision, please modify 'cellBit' in Param.cpp!" << endl;
-		param->cellBit = param->synapseBit;
+// Monte Carlo trials of the whole network (param->monteCarloTrials), every layer of every trial is a task; the traces are loaded once
+// and shared, each (trial, layer) draws from its own counter-based streams, so the results do not depend on the # of threads
+static void CalculateTrials(const ChipDesign &design, char *argv[], vector<ChipPerformance> &trials, vector<vector<MonteCarloStream> > &streams) {
+	int numLayer = design.netStructure.size();
+	int numTrial = param->monteCarloTrials;
+	vector<WeightMatrix> weight(numLayer);
+	vector<BitPlane> input(numLayer);
+	#pragma omp parallel for
+	for (int i=0; i<numLayer; i++) {
+		input[i] = LoadInInputData(argv[2*i+5]);
+		weight[i] = LoadInWeightData(argv[2*i+4], param->numRowPerSynapse, param->numColPerSynapse, param->maxConductance, param->minConductance);
 	}
-	param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit); 
-	param->numRowPerSynapse = 1;
-	
-	double maxPESizeNM, maxTileSizeCM, numPENM;
-	vector<int> markNM;
-	markNM = ChipDesignInitialize(inputParameter, tech, cell, netStructure, &maxPESizeNM, &maxTileSizeCM, &numPENM);		
-	
-	double desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM;
-	int numTileRow, numTileCol;
 	
-	vector<vector<double> > numTileEachLayer;
-	vector<vector<double> > utilizationEachLayer;
-	vector<vector<double> > speedUpEachLayer;
-	vector<vector<double> > tileLocaEachLayer;
-	
-	numTileEachLayer = ChipFloorPlan(true, false, false, netStructure, markNM, 
-					maxPESizeNM, maxTileSizeCM, numPENM, 
-					&desiredNumTileNM, &desiredPESizeNM, &desiredNumTileCM, &desiredTileSizeCM, &desiredPESizeCM, &numTileRow, &numTileCol);	
-					
-	utilizationEachLayer = ChipFloorPlan(false, true, false, netStructure, markNM, 
-					maxPESizeNM, maxTileSizeCM, numPENM,
-					&desiredNumTileNM, &desiredPESizeNM, &desiredNumTileCM, &desiredTileSizeCM, &desiredPESizeCM, &numTileRow, &numTileCol);
-	
-	speedUpEachLayer = ChipFloorPlan(false, false, true, netStructure, markNM,
-					maxPESizeNM, maxTileSizeCM, numPENM,
-					&desiredNumTileNM, &desiredPESizeNM, &desiredNumTileCM, &desiredTileSizeCM, &desiredPESizeCM, &numTileRow, &numTileCol);
-					
-	tileLocaEachLayer = ChipFloorPlan(false, false, false, netStructure, markNM,
-					maxPESizeNM, maxTileSizeCM, numPENM,
-					&desiredNumTileNM, &desiredPESizeNM, &desiredNumTileCM, &desiredTileSizeCM, &desiredPESizeCM, &numTileRow, &numTileCol);
-	
-	cout << "------------------------------ FloorPlan --------------------------------" <<  endl;
-	cout << endl;
-	cout << "Tile and PE size are optimized to maximize memory utilization ( = memory mapped by synapse / total memory on chip)" << endl;
-	cout << endl;
-	if (!param->novelMapping) {
-		cout << "Desired Conventional Mapped Tile Storage Size: " << desiredTileSizeCM << "x" << desiredTileSizeCM << endl;
-		cout << "Desired Conventional PE Storage Size: " << desiredPESizeCM << "x" << desiredPESizeCM << endl;
-	} else {
-		cout << "Desired Conventional Mapped Tile Storage Size: " << desiredTileSizeCM << "x" << desiredTileSizeCM << endl;
-		cout << "Desired Conventional PE Storage Size: " << desiredPESizeCM << "x" << desiredPESizeCM << endl;
-		cout << "Desired Novel Mapped Tile Storage Size: " << numPENM << "x" << desiredPESizeNM << "x" << desiredPESizeNM << endl;
-	}
-	cout << "User-defined SubArray Size: " << param->numRowSubArray << "x" << param->numColSubArray << endl;
-	cout << endl;
-	cout << "----------------- # of tile used for each layer -----------------" <<  endl;
-	double totalNumTile = 0;
-	for (int i=0; i<netStructure.size(); i++) {
-		cout << "layer" << i+1 << ": " << numTileEachLayer[0][i] * numTileEachLayer[1][i] << endl;
-		totalNumTile += numTileEachLayer[0][i] * numTileEachLayer[1][i];
-	}
-	cout << endl;
-
-	cout << "----------------- Speed-up of each layer ------------------" <<  endl;
-	for (int i=0; i<netStructure.size(); i++) {
-		cout << "layer" << i+1 << ": " << speedUpEachLayer[0][i] << ", " << speedUpEachLayer[1][i] << endl;
+	vector<vector<LayerPerformance> > layerPerformance(numTrial, vector<LayerPerformance>(numLayer));
+	streams.assign(numTrial, vector<MonteCarloStream>(numLayer));
+	for (int t=0; t<numTrial; t++) {
+		for (int i=0; i<numLayer; i++) {
+			streams[t][i] = MonteCarloStreamOf(t, i);
+		}
 	}
-	cout << endl;
-	
-	cout << "----------------- Utilization of each layer ------------------" <<  endl;
-	double realMappedMemory = 0;
-	for (int i=0; i<netStructure.size(); i++) {
-		cout << "layer" << i+1 << ": " << utilizationEachLayer[i][0] << endl;
-		realMappedMemory += numTileEachLayer[0][i] * numTileEachLayer[1][i] * utilizationEachLayer[i][0];
+	#pragma omp parallel
+	#pragma omp single
+	for (int t=0; t<numTrial; t++) {
+		for (int i=0; i<numLayer; i++) {
+			#pragma omp task default(shared) firstprivate(t, i)
+			NeuroSimCalculateLayer(design, i, weight[i], input[i], &layerPerformance[t][i], &streams[t][i]);
+		}
 	}
-	cout << "Memory Utilization of Whole Chip: " << realMappedMemory/totalNumTile*100 << " % " << endl;
-	cout << endl;
-	cout << "---------------------------- FloorPlan Done ------------------------------" <<  endl;
-	cout << endl;
-	cout << endl;
-	cout << endl;
 	
-	double numComputation = 0;
-	for (int i=0; i<netStructure.size(); i++) {
-		numComputation += netStructure[i][0] * netStructure[i][1] * netStructure[i][2] * netStructure[i][3] * netStructure[i][4] * netStructure[i][5];
+	trials.resize(numTrial);
+	for (int t=0; t<numTrial; t++) {
+		trials[t] = NeuroSimSummarize(design, layerPerformance[t]);
 	}
-	
-	ChipInitialize(inputParameter, tech, cell, netStructure, markNM, numTileEachLayer,
-					numPENM, desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, numTileCol);
-					
-	double chipHeight, chipWidth, chipArea, chipAreaIC, chipAreaADC, chipAreaAccum, chipAreaOther;
-	double CMTileheight = 0;
-	double CMTilewidth = 0;
-	double NMTileheight = 0;
-	double NMTilewidth = 0;
-	vector<double> chipAreaResults;
-						
-	chipAreaResults = ChipCalculateArea(inputParameter, tech, cell, desiredNumTileNM, numPENM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM, numTileRow, 
-					&chipHeight, &chipWidth, &CMTileheight, &CMTilewidth, &NMTileheight, &NMTilewidth);		
-	chipArea = chipAreaResults[0];
-	chipAreaIC = chipAreaResults[1];
-	chipAreaADC = chipAreaResults[2];
-	chipAreaAccum = chipAreaResults[3];
-	chipAreaOther = chipAreaResults[4];
+}
 
-	double chipReadLatency = 0;
-	double chipReadDynamicEnergy = 0;
-	double chipLeakageEnergy = 0;
-	double chipLeakage = 0;
-	double chipbufferLatency = 0;
-	double chipbufferReadDynamicEnergy = 0;
-	double chipicLatency = 0;
-	double chipicReadDynamicEnergy = 0;
-	
-	double chipLatencyADC = 0;
-	double chipLatencyAccum = 0;
-	double chipLatencyOther = 0;
-	double chipEnergyADC = 0;
-	double chipEnergyAccum = 0;
-	double chipEnergyOther = 0;
-	
-	double layerReadLatency = 0;
-	double layerReadDynamicEnergy = 0;
-	double tileLeakage = 0;
-	double layerbufferLatency = 0;
-	double layerbufferDynamicEnergy = 0;
-	double layericLatency = 0;
-	double layericDynamicEnergy = 0;
+
+int main(int argc, char * argv[]) {   
+
+	auto start = chrono::high_resolution_clock::now();
+
+	gen.seed(0);
 	
-	double coreLatencyADC = 0;
-	double coreLatencyAccum = 0;
-	double coreLatencyOther = 0;
-	double coreEnergyADC = 0;
-	double coreEnergyAccum = 0;
-	double coreEnergyOther = 0;
+	// --config file.ini / --set name=value override Param.cpp
+	param->ParseArguments(&argc, argv);
 	
-	cout << "-------------------------------------- Hardware Performance --------------------------------------" <<  endl;
+	vector<vector<double> > netStructure;
+	netStructure = getNetStructure(argv[1]);
 	
-	for (int i=0; i<netStructure.size(); i++) {
-		
-		cout << "-------------------- Estimation of Layer " << i+1 << " ----------------------" << endl;
-		
-		ChipCalculatePerformance(cell, i, argv[2*i+4], argv[2*i+4], argv[2*i+5], netStructure[i][6],
-					netStructure, markNM, numTileEachLayer, utilizationEachLayer, speedUpEachLayer, tileLocaEachLayer,
-					numPENM, desiredPESizeNM, desiredTileSizeCM, desiredPESizeCM, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth,
-					&layerReadLatency, &layerReadDynamicEnergy, &tileLeakage, &layerbufferLatency, &layerbufferDynamicEnergy, &layericLatency, &layericDynamicEnergy,
-					&coreLatencyADC, &coreLatencyAccum, &coreLatencyOther, &coreEnergyADC, &coreEnergyAccum, &coreEnergyOther);
-		
-		double numTileOtherLayer = 0;
-		double layerLeakageEnergy = 0;		
-		for (int j=0; j<netStructure.size(); j++) {
-			if (j != i) {
-				numTileOtherLayer += numTileEachLayer[0][j] * numTileEachLayer[1][j];
-			}
-		}
-		layerLeakageEnergy = numTileOtherLayer*layerReadLatency*tileLeakage;
-		
-		cout << "layer" << i+1 << "'s readLatency is: " << layerReadLatency*1e9 << "ns" << endl;
-		cout << "layer" << i+1 << "'s readDynamicEnergy is: " << layerReadDynamicEnergy*1e12 << "pJ" << endl;
-		cout << "layer" << i+1 << "'s leakagePower is: " << numTileEachLayer[0][i] * numTileEachLayer[1][i] * tileLeakage*1e6 << "uW" << endl;
-		cout << "layer" << i+1 << "'s leakageEnergy is: " << layerLeakageEnergy*1e12 << "pJ" << endl;
-		cout << "layer" << i+1 << "'s buffer latency is: " << layerbufferLatency*1e9 << "ns" << endl;
-		cout << "layer" << i+1 << "'s buffer readDynamicEnergy is: " << layerbufferDynamicEnergy*1e12 << "pJ" << endl;
-		cout << "layer" << i+1 << "'s ic latency is: " << layericLatency*1e9 << "ns" << endl;
-		cout << "layer" << i+1 << "'s ic readDynamicEnergy is: " << layericDynamicEnergy*1e12 << "pJ" << endl;
-		
-		
-		cout << endl;
-		cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-		cout << endl;
-		cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreLatencyADC*1e9 << "ns" << endl;
-		cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreLatencyAccum*1e9 << "ns" << endl;
-		cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreLatencyOther*1e9 << "ns" << endl;
-		cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << coreEnergyADC*1e12 << "pJ" << endl;
-		cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << coreEnergyAccum*1e12 << "pJ" << endl;
-		cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << coreEnergyOther*1e12 << "pJ" << endl;
-		cout << endl;
-		cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-		cout << endl;
-		
-		chipReadLatency += layerReadLatency;
-		chipReadDynamicEnergy += layerReadDynamicEnergy;
-		chipLeakageEnergy += layerLeakageEnergy;
-		chipLeakage += tileLeakage*numTileEachLayer[0][i] * numTileEachLayer[1][i];
-		chipbufferLatency += layerbufferLatency;
-		chipbufferReadDynamicEnergy += layerbufferDynamicEnergy;
-		chipicLatency += layericLatency;
-		chipicReadDynamicEnergy += layericDynamicEnergy;
-		
-		chipLatencyADC += coreLatencyADC;
-		chipLatencyAccum += coreLatencyAccum;
-		chipLatencyOther += coreLatencyOther;
-		chipEnergyADC += coreEnergyADC;
-		chipEnergyAccum += coreEnergyAccum;
-		chipEnergyOther += coreEnergyOther;
+	ChipDesign design;
+	NeuroSimFloorPlan(netStructure, atoi(argv[2]), atoi(argv[3]), &design);
+	NeuroSimPrintFloorPlan(design);
+	NeuroSimInitialize(&design);
+	auto initialized = chrono::high_resolution_clock::now();
+	
+	int numLayer = netStructure.size();
+	vector<LayerPerformance> layerPerformance(numLayer);
+	vector<int> layerCached(numLayer, 0);
+	bool useLayerCache = !param->layerCacheDir.empty();
+	
+	// fastEstimate=2: simulate the network, then estimate it and report how far the estimate is off
+	int fastEstimate = param->fastEstimate;
+	ChipPerformance exact;
+	double exactRunTime = 0;
+	if (fastEstimate == 2) {
+		param->fastEstimate = 0;
+		CalculateLayers(design, argv, layerPerformance, layerCached);
+		exact = NeuroSimSummarize(design, layerPerformance);
+		exactRunTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now()-initialized).count()/1e3;
+		param->fastEstimate = 1;
+	}
+	auto estimateStart = chrono::high_resolution_clock::now();
+	CalculateLayers(design, argv, layerPerformance, layerCached);
+	
+	ChipPerformance performance;
+	performance = NeuroSimSummarize(design, layerPerformance);
+	auto estimated = chrono::high_resolution_clock::now();
+	if (fastEstimate == 2) {
+		NeuroSimPrintPerformance(design, exact);
+		NeuroSimPrintComparison(design, exact, performance);
+		param->fastEstimate = fastEstimate;
+	} else {
+		NeuroSimPrintPerformance(design, performance);
 	}
 	
-	cout << "------------------------------ Summary --------------------------------" <<  endl;
-	cout << endl;
-	cout << "ChipArea : " << chipArea*1e12 << "um^2" << endl;
-	cout << "Total IC Area on chip (Global and Tile/PE local): " << chipAreaIC*1e12 << "um^2" << endl;
-	cout << "Total ADC (or S/As and precharger for SRAM) Area on chip : " << chipAreaADC*1e12 << "um^2" << endl;
-	cout << "Total Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) on chip : " << chipAreaAccum*1e12 << "um^2" << endl;
-	cout << "Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) : " << chipAreaOther*1e12 << "um^2" << endl;
-	cout << endl;
-	cout << "Chip total readLatency is: " << chipReadLatency*1e9 << "ns" << endl;
-	cout << "Chip total readDynamicEnergy is: " << chipReadDynamicEnergy*1e12 << "pJ" << endl;
-	cout << "Chip total leakage Energy is: " << chipLeakageEnergy*1e12 << "pJ" << endl;
-	cout << "Chip total leakage Power is: " << chipLeakage*1e6 << "uW" << endl;
-	cout << "Chip buffer readLatency is: " << chipbufferLatency*1e9 << "ns" << endl;
-	cout << "Chip buffer readDynamicEnergy is: " << chipbufferReadDynamicEnergy*1e12 << "pJ" << endl;
-	cout << "Chip ic readLatency is: " << chipicLatency*1e9 << "ns" << endl;
-	cout << "Chip ic readDynamicEnergy is: " << chipicReadDynamicEnergy*1e12 << "pJ" << endl;
-	
-	cout << endl;
-	cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-	cout << endl;
-	cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << chipLatencyADC*1e9 << "ns" << endl;
-	cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << chipLatencyAccum*1e9 << "ns" << endl;
-	cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << chipLatencyOther*1e9 << "ns" << endl;
-	cout << "----------- ADC (or S/As and precharger for SRAM) readLatency is : " << chipEnergyADC*1e12 << "pJ" << endl;
-	cout << "----------- Accumulation Circuits (subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units) readLatency is : " << chipEnergyAccum*1e12 << "pJ" << endl;
-	cout << "----------- Other Peripheries (e.g. decoders, mux, switchmatrix, buffers, IC, pooling and activation units) readLatency is : " << chipEnergyOther*1e12 << "pJ" << endl;
-	cout << endl;
-	cout << "************************ Breakdown of Latency and Dynamic Energy *************************" << endl;
-	cout << endl;
+	// the nominal evaluation above, then the spread caused by the device non-idealities
+	auto monteCarloStart = chrono::high_resolution_clock::now();
+	if (param->monteCarloTrials > 0) {
+		vector<ChipPerformance> trials;
+		vector<vector<MonteCarloStream> > streams;
+		CalculateTrials(design, argv, trials, streams);
+		NeuroSimPrintMonteCarlo(trials, streams);
+	}
+	auto monteCarloStop = chrono::high_resolution_clock::now();
 	
-	cout << endl;
-	cout << "----------------------------- Performance -------------------------------" << endl;
-	cout << "Energy Efficiency TOPS/W (Layer-by-Layer Process): " << numComputation/(chipReadDynamicEnergy*1e12+chipLeakageEnergy*1e12) << endl;
-	cout << "Throughput FPS (Layer-by-Layer Process): " << 1/(chipReadLatency) << endl;
-	cout << "-------------------------------------- Hardware Performance Done --------------------------------------" <<  endl;
-	cout << endl;
 	auto stop = chrono::high_resolution_clock::now();
 	auto duration = chrono::duration_cast<chrono::seconds>(stop-start);
     cout << "------------------------------ Simulation Performance --------------------------------" <<  endl;
 	cout << "Total Run-time of NeuroSim: " << duration.count() << " seconds" << endl;
+	cout << "Run-time of floorplan and initialization: " << chrono::duration_cast<chrono::microseconds>(initialized-start).count()/1e3 << " ms" << endl;
+	if (SubArray::totalReadCacheHit + SubArray::totalReadCacheMiss > 0) {
+		cout << "SubArray result cache: " << SubArray::totalReadCacheHit << " hits, " << SubArray::totalReadCacheMiss << " misses" << endl;
+	}
+	if (fastEstimate == 2) {
+		cout << "Run-time of the exact evaluation: " << exactRunTime << " ms, of the fast estimate: " 
+			 << chrono::duration_cast<chrono::microseconds>(estimated-estimateStart).count()/1e3 << " ms" << endl;
+	}
+	if (param->monteCarloTrials > 0) {
+		cout << "Run-time of the Monte Carlo trials: " << chrono::duration_cast<chrono::microseconds>(monteCarloStop-monteCarloStart).count()/1e3 << " ms" << endl;
+	}
+	if (useLayerCache) {
+		cout << "Layer cache: " << count(layerCached.begin(), layerCached.end(), 1) << " of " << numLayer << " layers loaded from " << param->layerCacheDir << endl;
+	}
 	cout << "------------------------------ Simulation Performance --------------------------------" <<  endl;
 	
 	return 0;
 }
-
-vector<vector<double> > getNetStructure(const string &inputfile) {
-	ifstream infile(inputfile.c_str());      
-	string inputline;
-	string inputval;
-
-	int ROWin=0, COLin=0;      
-	if (!infile.good()) {        
-		cerr << "Error: the input file cannot be opened!" << endl;
-		exit(1);
-	}else{
-		while (getline(infile, inputline, '\n')) {       
-			ROWin++;                                
-		}
-		infile.clear();
-		infile.seekg(0, ios::beg);      
-		if (getline(infile, inputline, '\n')) {        
-			istringstream iss (inputline);      
-			while (getline(iss, inputval, ',')) {       
-				COLin++;
-			}
-		}	
-	}
-	infile.clear();
-	infile.seekg(0, ios::beg);          
-
-	vector<vector<double> > netStructure;               
-	for (int row=0; row<ROWin; row++) {	
-		vector<double> netStructurerow;
-		getline(infile, inputline, '\n');             
-		istringstream iss;
-		iss.str(inputline);
-		for (int col=0; col<COLin; col++) {       
-			while(getline(iss, inputval, ',')){	
-				istringstream fs;
-				fs.str(inputval);
-				double f=0;
-				fs >> f;				
-				netStructurerow.push_back(f);			
-			}			
-		}		
-		netStructure.push_back(netStructurerow);
-	}
-	infile.close();
-	
-	return netStructure;
-	netStructure.clear();
-}	
-
-
-
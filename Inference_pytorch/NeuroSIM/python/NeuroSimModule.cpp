@@ -0,0 +1,264 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+// Python binding of the chip pipeline (NeuroSim.h), built with "make python":
+//
+//   import neurosim
+//   neurosim.configure('chip.ini', {'numColMuxed': '16'})     # optional, same as main --config/--set
+//   chip = neurosim.Chip('./NeuroSIM/NetWork.csv', 8, 8)     # floorplan + initialization, done once
+//   result = chip.evaluate(weights, inputs)                   # lists of numpy arrays, one pair per layer
+//   chip.report(result)                                       # same report as ./NeuroSIM/main
+//
+// weights[l] is the weight matrix of layer l and inputs[l] its bit-serial input matrix, in the layout of the
+// trace files written by the hooks (numRow x numCol weights, numRow x numInVector bits), or for conv layers a
+// (featureMap, kernel, stride, padding) tuple of the int8 activation codes, expanded in C++
+//
+// "make check-python" runs python/smoke.py: one evaluate on NetWork.csv must give the report of ./main for the same traces
+
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdexcept>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <pybind11/iostream.h>
+#include "../constant.h"
+#include "../formula.h"
+#include "../Param.h"
+#include "../Tile.h"
+#include "../Chip.h"
+#include "../ProcessingUnit.h"
+#include "../SubArray.h"
+#include "../NeuroSim.h"
+#include "../Definition.h"
+
+namespace py = pybind11;
+
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> WeightArray;
+typedef py::array_t<unsigned char, py::array::c_style | py::array::forcecast> InputArray;
+typedef py::array_t<int8_t, py::array::c_style | py::array::forcecast> FeatureMapArray;
+
+class Chip {
+public:
+	Chip(py::object network, int synapseBit, int numBitInput) {
+		vector<vector<double> > netStructure;
+		if (py::isinstance<py::str>(network)) {
+			netStructure = getNetStructure(network.cast<string>());
+		} else {
+			netStructure = network.cast<vector<vector<double> > >();
+		}
+		for (int i=0; i<netStructure.size(); i++) {
+			if (netStructure[i].size() < 7) {
+				throw std::invalid_argument("each layer of the network needs 7 entries (IFM x, IFM y, IFM z, kernel x, kernel y, kernel z, pooling)");
+			}
+		}
+		gen.seed(0);
+		NeuroSimFloorPlan(netStructure, synapseBit, numBitInput, &design);
+		NeuroSimInitialize(&design);
+	}
+	~Chip() {
+		NeuroSimFree(&design);
+	}
+	
+	py::dict Evaluate(const vector<WeightArray> &weightArray, const vector<py::object> &inputArray) {
+		int numLayer = design.netStructure.size();
+		if (weightArray.size() != numLayer || inputArray.size() != numLayer) {
+			throw std::invalid_argument("expected one weight and one input matrix per layer");
+		}
+		vector<WeightMatrix> weight(numLayer);
+		vector<BitPlane> input(numLayer);
+		for (int l=0; l<numLayer; l++) {
+			const WeightArray &w = weightArray[l];
+			if (w.ndim() != 2) {
+				throw std::invalid_argument("weights must be 2-D matrices");
+			}
+			int weightMatrixRow = design.netStructure[l][2]*design.netStructure[l][3]*design.netStructure[l][4]*design.numRowPerSynapse;
+			if (w.shape(0) != weightMatrixRow || w.shape(1) != (int) design.netStructure[l][5]) {
+				throw std::invalid_argument("weights of layer " + to_string(l+1) + " do not match the network structure");
+			}
+			weight[l] = LoadInWeightArray(w.data(), w.shape(0), w.shape(1), design.numRowPerSynapse, design.numColPerSynapse, param->maxConductance, param->minConductance);
+			if (py::isinstance<py::tuple>(inputArray[l])) {
+				input[l] = LoadFeatureMap(l, inputArray[l].cast<py::tuple>());
+			} else {
+				InputArray in = inputArray[l].cast<InputArray>();
+				if (in.ndim() != 2 || in.shape(0) != weightMatrixRow) {
+					throw std::invalid_argument("inputs of layer " + to_string(l+1) + " do not match the network structure");
+				}
+				input[l] = LoadInInputArray(in.data(), in.shape(0), in.shape(1));
+			}
+		}
+		
+		ChipPerformance performance;
+		{
+			py::gil_scoped_release release;
+			performance = NeuroSimCalculatePerformance(design, weight, input);
+		}
+		return ToDict(performance);
+	}
+	
+	// (featureMap, kernel, stride, padding): int8 codes of a C x H x W (or 1 x C x H x W) feature map, expanded by LoadInFeatureMap
+	BitPlane LoadFeatureMap(int l, const py::tuple &t) {
+		if (t.size() != 4) {
+			throw std::invalid_argument("feature map inputs are (featureMap, kernel, stride, padding) tuples");
+		}
+		FeatureMapArray map = t[0].cast<FeatureMapArray>();
+		int kernel = t[1].cast<int>(), stride = t[2].cast<int>(), padding = t[3].cast<int>();
+		int batchDim = (map.ndim() == 4 && map.shape(0) == 1)? 1 : 0;
+		if (map.ndim() - batchDim != 3 || kernel <= 0 || stride <= 0) {
+			throw std::invalid_argument("invalid feature map of layer " + to_string(l+1));
+		}
+		int numChannel = map.shape(batchDim), height = map.shape(batchDim+1), width = map.shape(batchDim+2);
+		int outHeight = (height + 2*padding - kernel)/stride + 1;
+		int outWidth = (width + 2*padding - kernel)/stride + 1;
+		const vector<double> &layer = design.netStructure[l];
+		if (numChannel*kernel*kernel != (int) (layer[2]*layer[3]*layer[4]*design.numRowPerSynapse)
+				|| outHeight*outWidth < (int) ((layer[0]-layer[3]+1)*(layer[1]-layer[4]+1))) {
+			throw std::invalid_argument("feature map of layer " + to_string(l+1) + " does not match the network structure");
+		}
+		return LoadInFeatureMap(map.data(), numChannel, height, width, kernel, stride, padding, design.numBitInput);
+	}
+	
+	void Report(py::dict result) {
+		ChipPerformance performance;
+		performance = NeuroSimSummarize(design, result["layer"].cast<vector<vector<double> > >());
+		py::scoped_ostream_redirect stream;
+		NeuroSimPrintPerformance(design, performance);
+	}
+	
+	py::dict FloorPlan() {
+		py::dict d;
+		d["numTileEachLayer"] = design.numTileEachLayer;
+		d["utilizationEachLayer"] = design.utilizationEachLayer;
+		d["speedUpEachLayer"] = design.speedUpEachLayer;
+		d["desiredTileSizeCM"] = design.desiredTileSizeCM;
+		d["desiredPESizeCM"] = design.desiredPESizeCM;
+		d["desiredPESizeNM"] = design.desiredPESizeNM;
+		d["numPENM"] = design.numPENM;
+		d["chipArea"] = design.chipAreaResults[0];
+		d["chipAreaIC"] = design.chipAreaResults[1];
+		d["chipAreaADC"] = design.chipAreaResults[2];
+		d["chipAreaAccum"] = design.chipAreaResults[3];
+		d["chipAreaOther"] = design.chipAreaResults[4];
+		return d;
+	}
+	
+	ChipDesign design;
+	
+private:
+	static py::dict ToDict(const LayerPerformance &layer) {
+		py::dict d;
+		d["readLatency"] = layer.readLatency;
+		d["readDynamicEnergy"] = layer.readDynamicEnergy;
+		d["leakage"] = layer.leakage;
+		d["bufferLatency"] = layer.bufferLatency;
+		d["bufferDynamicEnergy"] = layer.bufferDynamicEnergy;
+		d["icLatency"] = layer.icLatency;
+		d["icDynamicEnergy"] = layer.icDynamicEnergy;
+		d["latencyADC"] = layer.latencyADC;
+		d["latencyAccum"] = layer.latencyAccum;
+		d["latencyOther"] = layer.latencyOther;
+		d["energyADC"] = layer.energyADC;
+		d["energyAccum"] = layer.energyAccum;
+		d["energyOther"] = layer.energyOther;
+		d["numVector"] = layer.sampling.numVector;		// sampled input vectors (param->sampleError > 0)
+		d["numSampled"] = layer.sampling.numSampled;
+		d["relativeError"] = vector<double>(layer.sampling.relativeError, layer.sampling.relativeError+9);
+		return d;
+	}
+	
+	static py::dict ToDict(const ChipPerformance &performance) {
+		py::dict d;
+		py::list layer;
+		for (size_t i=0; i<performance.layer.size(); i++) {
+			layer.append(ToDict(performance.layer[i]));
+		}
+		d["layer"] = layer;
+		d["layerLeakageEnergy"] = performance.layerLeakageEnergy;
+		d["readLatency"] = performance.readLatency;
+		d["readDynamicEnergy"] = performance.readDynamicEnergy;
+		d["leakageEnergy"] = performance.leakageEnergy;
+		d["leakage"] = performance.leakage;
+		d["bufferLatency"] = performance.bufferLatency;
+		d["bufferDynamicEnergy"] = performance.bufferDynamicEnergy;
+		d["icLatency"] = performance.icLatency;
+		d["icDynamicEnergy"] = performance.icDynamicEnergy;
+		d["latencyADC"] = performance.latencyADC;
+		d["latencyAccum"] = performance.latencyAccum;
+		d["latencyOther"] = performance.latencyOther;
+		d["energyADC"] = performance.energyADC;
+		d["energyAccum"] = performance.energyAccum;
+		d["energyOther"] = performance.energyOther;
+		d["TOPSperW"] = performance.numComputation/(performance.readDynamicEnergy*1e12+performance.leakageEnergy*1e12);
+		d["FPS"] = 1/performance.readLatency;
+		return d;
+	}
+};
+
+// same as ./NeuroSIM/main --config ... --set name=value, applies to the chips created afterwards
+void Configure(const string &config, const std::map<string, string> &overrides) {
+	if (!config.empty() && !param->LoadConfig(config)) {
+		throw std::invalid_argument("cannot load the config file " + config);
+	}
+	for (std::map<string, string>::const_iterator it = overrides.begin(); it != overrides.end(); it++) {
+		if (!param->Override(it->first, it->second)) {
+			throw std::invalid_argument("invalid parameter " + it->first + " = " + it->second);
+		}
+	}
+	param->Update();
+}
+
+PYBIND11_MODULE(neurosim, m) {
+	m.doc() = "NeuroSim chip pipeline, initialized once and evaluated on in-memory weights and activations";
+	
+	m.def("configure", &Configure, py::arg("config") = "", py::arg("overrides") = std::map<string, string>(),
+		"Load a Param config file (name = value lines) and/or override fields by name, before creating a Chip");
+	
+	py::class_<Chip>(m, "Chip")
+		.def(py::init<py::object, int, int>(), py::arg("network"), py::arg("synapseBit"), py::arg("numBitInput"),
+			"Floorplan and initialize the chip for a network (NetWork.csv path or list of layers). "
+			"Param, Technology and MemCell are process-wide, so only the last chip created is valid.")
+		.def("evaluate", &Chip::Evaluate, py::arg("weights"), py::arg("inputs"),
+			"Evaluate one inference, returns per-layer and chip results (SI units)")
+		.def("report", &Chip::Report, py::arg("result"), "Print the report of ./NeuroSIM/main for a result of evaluate")
+		.def("floorplan", &Chip::FloorPlan, "Tile/PE sizes, tiles and utilization per layer, chip area breakdown");
+}
@@ -0,0 +1,80 @@
+"""Smoke check of the Python binding, run with "make check-python" (builds main and the module first):
+
+    python3 python/smoke.py [NetWork.csv] [synapseBit] [numBitInput]
+
+Random weights and inputs (fixed seed) are written as trace files for ./main and passed as numpy arrays to one
+neurosim.Chip.evaluate on the same network; the report of the module must match the one of ./main line by line
+(run-times and cache statistics aside). Exits with 1 on a mismatch.
+"""
+import contextlib
+import io
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import numpy as np
+
+sys.path.insert(0, os.getcwd())
+import neurosim
+
+
+def traces(network, numBitInput, rng):
+    weights, inputs = [], []
+    for x, y, z, kx, ky, k, _ in network:
+        numRow = z*kx*ky
+        numInVector = (x-kx+1)*(y-ky+1)
+        weights.append(rng.uniform(-1, 1, (numRow, k)))
+        inputs.append((rng.uniform(0, 1, (numRow, numInVector*numBitInput)) < 0.3).astype(np.uint8))
+    return weights, inputs
+
+
+def comparable(lines):
+    return [l for l in lines if l.strip() and 'Run-time' not in l and 'cache' not in l]
+
+
+def main():
+    networkFile = sys.argv[1] if len(sys.argv) > 1 else 'NetWork.csv'
+    synapseBit = int(sys.argv[2]) if len(sys.argv) > 2 else 8
+    numBitInput = int(sys.argv[3]) if len(sys.argv) > 3 else 8
+    network = [[int(float(v)) for v in l.split(',')] for l in open(networkFile) if l.strip()]
+    weights, inputs = traces(network, numBitInput, np.random.RandomState(0))
+
+    workdir = tempfile.mkdtemp(prefix='neurosim_smoke_')
+    try:
+        args = ['./main', networkFile, str(synapseBit), str(numBitInput)]
+        for l in range(len(network)):
+            weightFile = os.path.join(workdir, 'weight%d.csv' % l)
+            inputFile = os.path.join(workdir, 'input%d.csv' % l)
+            np.savetxt(weightFile, weights[l], fmt='%.17g', delimiter=',')    # exact round trip of the doubles
+            np.savetxt(inputFile, inputs[l], fmt='%d', delimiter=',')
+            args += [weightFile, inputFile]
+        expected = subprocess.run(args, stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout.splitlines()
+    finally:
+        shutil.rmtree(workdir)
+
+    chip = neurosim.Chip(networkFile, synapseBit, numBitInput)
+    result = chip.evaluate(weights, inputs)
+    report = io.StringIO()
+    with contextlib.redirect_stdout(report):
+        chip.report(result)
+    report = comparable(report.getvalue().splitlines())
+    expected = comparable(expected)
+
+    if not report or report[0] not in expected:
+        print('FAILED: the report of the module does not appear in the output of ./main')
+        return 1
+    start = expected.index(report[0])
+    for i, line in enumerate(report):
+        if start+i >= len(expected) or expected[start+i] != line:
+            print('FAILED: line %d of the report differs' % (i+1))
+            print('  main:   %s' % (expected[start+i] if start+i < len(expected) else '(end of output)'))
+            print('  module: %s' % line)
+            return 1
+    print('OK: %d report lines of neurosim.Chip.evaluate match ./main on %s' % (len(report), networkFile))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
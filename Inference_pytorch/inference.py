@@ -27,6 +27,7 @@ parser.add_argument('--wl_weight', default=2)
 parser.add_argument('--wl_grad', default=8)
 parser.add_argument('--wl_activate', default=8)
 parser.add_argument('--wl_error', default=8)
+parser.add_argument('--trace_format', default='csv', help='csv|bin|lib, format of the layer traces passed to NeuroSIM (lib: in-process, needs "make python" in NeuroSIM)')
 current_time = datetime.now().strftime('%Y_%m_%d_%H_%M_%S')
 
 args = parser.parse_args()
@@ -71,7 +72,7 @@ trained_with_quantization = True
 # for data, target in test_loader:
 for i, (data, target) in enumerate(test_loader):
     if i==0:
-        hook_handle_list = hook.hardware_evaluation(model,args.wl_weight,args.wl_activate)
+        hook_handle_list = hook.hardware_evaluation(model,args.wl_weight,args.wl_activate,args.trace_format)
     indx_target = target.clone()
     if args.cuda:
         data, target = data.cuda(), target.cuda()
@@ -90,4 +91,7 @@ acc = 100. * correct / len(test_loader.dataset)
 logger('Test set: Average loss: {:.4f}, Accuracy: {}/{} ({:.0f}%)'.format(
     test_loss, correct, len(test_loader.dataset), acc))
 
-call(["/bin/bash", "./layer_record/trace_command.sh"])
\ No newline at end of file
+if args.trace_format == 'lib':
+    hook.run_neurosim('./NeuroSIM/NetWork.csv', args.wl_weight, args.wl_activate)
+else:
+    call(["/bin/bash", "./layer_record/trace_command.sh"])
\ No newline at end of file
@@ -1,5 +1,6 @@
 #from modules.quantize import quantize, quantize_grad, QConv2d, QLinear, RangeBN
 import os
+import struct
 import torch.nn as nn
 import shutil
 from modules.quantization_cpu_np_infer import QConv2d,QLinear
@@ -7,42 +8,116 @@ import numpy as np
 import torch
 from utee import wage_quantizer
 
+# binary trace format read by NeuroSIM/TraceFile.cpp
+TRACE_MAGIC = b'NSTR'
+TRACE_VERSION = 1
+TRACE_HEADER_SIZE = 64
+TRACE_DTYPE = {np.dtype(np.float32): 0, np.dtype(np.float64): 1, np.dtype(np.uint8): 2, np.dtype(np.int8): 3}
+
+# weight and input matrices of each hooked layer, in execution order, for trace_format 'lib'
+layer_data = []
+
 def Neural_Sim(self, input, output):
-    input_file_name =  './layer_record/input' + str(self.name) + '.csv'
-    weight_file_name =  './layer_record/weight' + str(self.name) + '.csv'
+    trace_format = getattr(self, 'trace_format', 'csv')
+    weight_q = wage_quantizer.Q(self.weight,self.wl_weight)
+    if trace_format == 'lib':
+        # keep the matrices in memory, they are passed to the neurosim module by run_neurosim
+        if len(self.weight.shape) > 2:
+            k=self.weight.shape[-1]
+            if self.wl_input <= 8:
+                activation = (feature_map(input[0].cpu().data.numpy(),self.wl_input), k, 1, 0)
+            else:
+                activation = activation_matrix_conv(stretch_input(input[0].cpu().data.numpy(),k),self.wl_input)
+        else:
+            activation = activation_matrix_fc(input[0].cpu().data.numpy(),self.wl_input)
+        layer_data.append((weight_matrix(weight_q.cpu().data.numpy()), activation))
+        return
+    ext = '.bin' if trace_format == 'bin' else '.csv'
+    input_file_name =  './layer_record/input' + str(self.name) + ext
+    weight_file_name =  './layer_record/weight' + str(self.name) + ext
     f = open('./layer_record/trace_command.sh', "a")
     f.write(weight_file_name+' '+input_file_name+' ')
-    weight_q = wage_quantizer.Q(self.weight,self.wl_weight)
-    write_matrix_weight( weight_q.cpu().data.numpy(),weight_file_name)
+    write_matrix_weight( weight_q.cpu().data.numpy(),weight_file_name,trace_format,self.wl_weight)
     if len(self.weight.shape) > 2:
         k=self.weight.shape[-1]
-        write_matrix_activation_conv(stretch_input(input[0].cpu().data.numpy(),k),None,self.wl_input,input_file_name)
+        if trace_format == 'bin' and self.wl_input <= 8:
+            write_feature_map(input[0].cpu().data.numpy(),k,self.wl_input,input_file_name)
+        else:
+            write_matrix_activation_conv(stretch_input(input[0].cpu().data.numpy(),k),None,self.wl_input,input_file_name,trace_format)
     else:
-        write_matrix_activation_fc(input[0].cpu().data.numpy(),None ,self.wl_input, input_file_name)
-
-def write_matrix_weight(input_matrix,filename):
+        write_matrix_activation_fc(input[0].cpu().data.numpy(),None ,self.wl_input, input_file_name,trace_format)
+
+def run_neurosim(network,wl_weight,wl_activation,chip=None):
+    # evaluate the recorded layers in-process, the chip can be passed back in to skip the floorplan/initialization
+    import sys
+    sys.path.insert(0, './NeuroSIM')
+    import neurosim
+    if chip is None:
+        chip = neurosim.Chip(network, int(wl_weight), int(wl_activation))
+    result = chip.evaluate([w for w,_ in layer_data], [a for _,a in layer_data])
+    chip.report(result)
+    return chip, result
+
+def write_trace(matrix,filename,bit_width=0,geometry=(0,0,0,0,0)):
+    # geometry: height, width, kernel, stride, padding of an int8 feature map trace
+    matrix = np.ascontiguousarray(matrix, dtype=matrix.dtype.newbyteorder('<'))
+    header = struct.pack('<4sIIIQQQIIIII4x', TRACE_MAGIC, TRACE_VERSION, TRACE_DTYPE[matrix.dtype.newbyteorder('=')],
+                         int(bit_width), matrix.shape[0], matrix.shape[1], TRACE_HEADER_SIZE, *geometry)
+    with open(filename, 'wb') as f:
+        f.write(header)
+        matrix.tofile(f)
+
+def weight_matrix(input_matrix):
     cout = input_matrix.shape[0]
-    weight_matrix = input_matrix.reshape(cout,-1).transpose()
-    np.savetxt(filename, weight_matrix, delimiter=",",fmt='%10.5f')
+    return input_matrix.reshape(cout,-1).transpose()
+
+def write_matrix_weight(input_matrix,filename,trace_format='csv',bit_width=0):
+    if trace_format == 'bin':
+        write_trace(weight_matrix(input_matrix).astype(np.float32), filename, bit_width)
+    else:
+        np.savetxt(filename, weight_matrix(input_matrix), delimiter=",",fmt='%10.5f')
+
+
 
 
+def feature_map(input_matrix,length):
+    # activation codes of the first image (C x H x W), two's complement of the bits dec2bin produces
+    delta = 1.0/(2**(length-1))
+    codes = np.floor(input_matrix[0]/delta)
+    return np.clip(codes, -2**(length-1), 2**(length-1)-1).astype(np.int8)
 
+def write_feature_map(input_matrix,kernel,length,filename,stride=1,padding=0):
+    # raw feature map instead of the stretched bit matrix, NeuroSIM generates the windows and bit-planes itself
+    fmap = feature_map(input_matrix,length)
+    c,h,w = fmap.shape
+    write_trace(fmap.reshape(c,h*w), filename, length, (h,w,kernel,stride,padding))
 
-def write_matrix_activation_conv(input_matrix,fill_dimension,length,filename):
-    filled_matrix_b = np.zeros([input_matrix.shape[2],input_matrix.shape[1]*length],dtype=np.str)
+def activation_matrix_conv(input_matrix,length,dtype=np.uint8):
+    filled_matrix_b = np.zeros([input_matrix.shape[2],input_matrix.shape[1]*length],dtype=dtype)
     filled_matrix_bin,scale = dec2bin(input_matrix[0,:],length)
     for i,b in enumerate(filled_matrix_bin):
         filled_matrix_b[:,i::length] =  b.transpose()
-    np.savetxt(filename, filled_matrix_b, delimiter=",",fmt='%s')
+    return filled_matrix_b
 
+def write_matrix_activation_conv(input_matrix,fill_dimension,length,filename,trace_format='csv'):
+    if trace_format == 'bin':
+        write_trace(activation_matrix_conv(input_matrix,length), filename, length)
+    else:
+        np.savetxt(filename, activation_matrix_conv(input_matrix,length,np.str), delimiter=",",fmt='%s')
 
-def write_matrix_activation_fc(input_matrix,fill_dimension,length,filename):
 
-    filled_matrix_b = np.zeros([input_matrix.shape[1],length],dtype=np.str)
+def activation_matrix_fc(input_matrix,length,dtype=np.uint8):
+    filled_matrix_b = np.zeros([input_matrix.shape[1],length],dtype=dtype)
     filled_matrix_bin,scale = dec2bin(input_matrix[0,:],length)
     for i,b in enumerate(filled_matrix_bin):
         filled_matrix_b[:,i] =  b
-    np.savetxt(filename, filled_matrix_b, delimiter=",",fmt='%s')
+    return filled_matrix_b
+
+def write_matrix_activation_fc(input_matrix,fill_dimension,length,filename,trace_format='csv'):
+    if trace_format == 'bin':
+        write_trace(activation_matrix_fc(input_matrix,length), filename, length)
+    else:
+        np.savetxt(filename, activation_matrix_fc(input_matrix,length,np.str), delimiter=",",fmt='%s')
 
 def stretch_input(input_matrix,window_size = 5):
     input_shape = input_matrix.shape
@@ -98,8 +173,9 @@ def remove_hook_list(hook_handle_list):
     for handle in hook_handle_list:
         handle.remove()
 
-def hardware_evaluation(model,wl_weight,wl_activation):
+def hardware_evaluation(model,wl_weight,wl_activation,trace_format='csv'):
     hook_handle_list = []
+    del layer_data[:]
     if not os.path.exists('./layer_record'):
         os.makedirs('./layer_record')
     if os.path.exists('./layer_record/trace_command.sh'):
@@ -108,8 +184,10 @@ def hardware_evaluation(model,wl_weight,wl_activation):
     f.write('./NeuroSIM/main ./NeuroSIM/NetWork.csv '+str(wl_weight)+' '+str(wl_activation)+' ')
     for i, layer in enumerate(model.features.modules()):
         if isinstance(layer, QConv2d) or isinstance(layer,QLinear):
+            layer.trace_format = trace_format
             hook_handle_list.append(layer.register_forward_hook(Neural_Sim))
     for i, layer in enumerate(model.classifier.modules()):
         if isinstance(layer, QLinear):
+            layer.trace_format = trace_format
             hook_handle_list.append(layer.register_forward_hook(Neural_Sim))
     return hook_handle_list
\ No newline at end of file
@@ -91,7 +91,7 @@ def main():
     errorTestBest = getErrorTest()
     print 'Test Error:', errorTestBest
     H, W = sess.run([Net[0].input_array, Net[0].W_b])
-    hardware_estimation(H,W,Option.bitsW,Option.bitsA)
+    hardware_estimation(H,W,Option.bitsW,Option.bitsA,Option.traceFormat)
 
 
   else:
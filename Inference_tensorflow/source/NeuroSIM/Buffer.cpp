@@ -76,6 +76,8 @@ void Buffer::Initialize(int _numBit, int _interface_width, int _num_interface, d
 	} else {
 		widthInvN = MIN_NMOS_SIZE * tech.featureSize;
 		widthInvP = tech.pnSizeRatio * MIN_NMOS_SIZE * tech.featureSize;
+		widthTgN = MIN_NMOS_SIZE * tech.featureSize;
+		widthTgP = tech.pnSizeRatio * MIN_NMOS_SIZE * tech.featureSize;
 	}
 	
 	wlDecoder.Initialize(REGULAR_ROW, (int)ceil((double)log2((double)ceil((double)numBit/(double)interface_width))), false, false);
@@ -130,13 +132,15 @@ void Buffer::CalculateArea(double _newHeight, double _newWidth, AreaModify _opti
 				break;
 		}
 
-		// Capacitance
-		// INV
-		CalculateGateCapacitance(INV, 1, widthInvN, widthInvP, hDffInv, tech, &capInvInput, &capInvOutput);
-		// TG
-		capTgGateN = CalculateGateCap(widthTgN, tech);
-		capTgGateP = CalculateGateCap(widthTgP, tech);
-		CalculateGateCapacitance(INV, 1, widthTgN, widthTgP, hDffInv, tech, NULL, &capTgDrain);
+		// Capacitance (DFF only, the INV and TG sizes and hDffInv are not set for SRAM)
+		if (!SRAM) {
+			// INV
+			CalculateGateCapacitance(INV, 1, widthInvN, widthInvP, hDffInv, tech, &capInvInput, &capInvOutput);
+			// TG
+			capTgGateN = CalculateGateCap(widthTgN, tech);
+			capTgGateP = CalculateGateCap(widthTgP, tech);
+			CalculateGateCapacitance(INV, 1, widthTgN, widthTgP, hDffInv, tech, NULL, &capTgDrain);
+		}
 	}
 }
 
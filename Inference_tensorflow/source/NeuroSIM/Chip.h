@@ -39,13 +39,47 @@
 #ifndef CHIP_H_
 #define CHIP_H_
 
+#include "BitPlane.h"
+#include "MatrixView.h"
+#include "Buffer.h"
+#include "HTree.h"
+#include "AdderTree.h"
+#include "Sigmoid.h"
+#include "BitShifter.h"
+#include "MaxPooling.h"
+#include "Tile.h"
+
+/*** Circuit modules of the whole chip, private to each thread ***/
+struct ChipContext {
+	Buffer *globalBuffer;
+	HTree *GhTree;
+	AdderTree *Gaccumulation;
+	Sigmoid *Gsigmoid;
+	BitShifter *GreLu;
+	MaxPooling *maxPool;
+	TileContext tile;
+};
+
+/* Outcome of the floorplan search: tile/PE sizes and the per-layer mapping, all from one pass */
+struct FloorPlan {
+	double desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM;
+	int numTileRow, numTileCol;
+	vector<vector<double> > numTileEachLayer;
+	vector<vector<double> > utilizationEachLayer;
+	vector<vector<double> > speedUpEachLayer;
+	vector<vector<double> > tileLocaEachLayer;
+};
+
 /*** Functions ***/
+ChipContext ChipSaveContext();
+void ChipLoadContext(const ChipContext &context);
+ChipContext ChipCloneContext(const ChipContext &context);
+void ChipFreeContext(ChipContext &context);
+
 vector<int> ChipDesignInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, const vector<vector<double> > &netStructure,
 					double *maxPESizeNM, double *maxTileSizeCM, double *numPENM);
 					
-vector<vector<double> > ChipFloorPlan(bool findNumTile, bool findUtilization, bool findSpeedUp, const vector<vector<double> > &netStructure, const vector<int > &markNM, 
-					double maxPESizeNM, double maxTileSizeCM, double numPENM, 
-					double *desiredNumTileNM, double *desiredPESizeNM, double *desiredNumTileCM, double *desiredTileSizeCM, double *desiredPESizeCM, int *numTileRow, int *numTileCol);
+FloorPlan ChipFloorPlan(const vector<vector<double> > &netStructure, const vector<int > &markNM, double maxPESizeNM, double maxTileSizeCM, double numPENM);
 					
 void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, const vector<vector<double> > &netStructure, const vector<int > &markNM, const vector<vector<double> > &numTileEachLayer,
 					double numPENM, double desiredNumTileNM, double desiredPESizeNM, double desiredNumTileCM, double desiredTileSizeCM, double desiredPESizeCM, int numTileRow, int numTileCol);
@@ -53,12 +87,13 @@ void ChipInitialize(InputParameter& inputParameter, Technology& tech, MemCell& c
 vector<double> ChipCalculateArea(InputParameter& inputParameter, Technology& tech, MemCell& cell, double desiredNumTileNM, double numPENM, double desiredPESizeNM, double desiredNumTileCM, double desiredTileSizeCM, double desiredPESizeCM, 
 						int numTileRow, double *height, double *width, double *CMTileheight, double *CMTilewidth, double *NMTileheight, double *NMTilewidth);
 						
-double ChipCalculatePerformance(MemCell& cell, int layerNumber, const string &newweightfile, const string &oldweightfile, const string &inputfile, bool followedByMaxPool, const vector<vector<double> > &netStructure, 
+void ChipCalculatePerformance(MemCell& cell, int layerNumber, const WeightMatrix &newMemory, const BitPlane &inputVector, bool followedByMaxPool, const vector<vector<double> > &netStructure, 
 							const vector<int> &markNM, const vector<vector<double> > &numTileEachLayer, const vector<vector<double> > &utilizationEachLayer, const vector<vector<double> > &speedUpEachLayer, 
 							const vector<vector<double> > &tileLocaEachLayer, double numPENM, double desiredPESizeNM, double desiredTileSizeCM, double desiredPESizeCM, 
 							double CMTileheight, double CMTilewidth, double NMTileheight, double NMTilewidth, double *readLatency, double *readDynamicEnergy, 
 							double *leakage, double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
-							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther);
+							double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther,
+							MonteCarloStream *variation=NULL, SamplingStatistics *sampling=NULL);
 							
 vector<double> TileDesignCM(double tileSize, const vector<int > &markNM, const vector<vector<double> > &netStructure, int numRowPerSynapse, int numColPerSynapse);
 vector<double> TileDesignNM(double peSize, const vector<int > &markNM, const vector<vector<double> > &netStructure, int numRowPerSynapse, int numColPerSynapse, double numPENM);
@@ -67,11 +102,13 @@ vector<vector<double> > SubArrayDup(double desiredPESizeCM, double desiredPESize
 vector<vector<double> > OverallEachLayer(bool utilization, bool speedUp, const vector<vector<double> > &peDup, const vector<vector<double> > &subArrayDup, double desiredTileSizeCM, double desiredPESizeNM, 
 										const vector<int > &markNM, const vector<vector<double> > &netStructure, int numRowPerSynapse, int numColPerSynapse, double numPENM);
 
-vector<vector<double> > LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance);
-vector<vector<double> > CopyArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol);
-vector<vector<double> > ReshapeArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol, int numPE, int weightMatrixRow);
-vector<vector<double> > LoadInInputData(const string &inputfile);
-vector<vector<double> > CopyInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow);
-vector<vector<double> > ReshapeInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow, int numPE, int weightMatrixRow);
+WeightMatrix LoadInWeightData(const string &weightfile, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance);
+void WeightToCellCode(double f, int numColPerSynapse, vector<uint8_t> &weightrow);
+BitPlane LoadInInputData(const string &inputfile);
+WeightMatrix LoadInWeightArray(const double *data, int numRow, int numCol, int numRowPerSynapse, int numColPerSynapse, double maxConductance, double minConductance);
+BitPlane LoadInInputArray(const unsigned char *data, int numRow, int numCol);
+BitPlane LoadInFeatureMap(const int8_t *data, int numChannel, int height, int width, int kernel, int stride, int padding, int numBitInput);
+BitPlane CopyInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow);
+BitPlane ReshapeInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow, int numPE, int weightMatrixRow);
 
 #endif /* CHIP_H_ */
\ No newline at end of file
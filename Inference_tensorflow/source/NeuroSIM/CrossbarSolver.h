@@ -0,0 +1,90 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef CROSSBARSOLVER_H_
+#define CROSSBARSOLVER_H_
+
+#include <vector>
+#include "MemCell.h"
+#include "MatrixView.h"
+#include "BitPlane.h"
+
+using namespace std;
+
+struct MonteCarloStream;
+
+/* Nodal analysis of the wires of one eNVM subArray (param->irDropSolver), instead of adding (j+1)*wireResistanceRow +
+   (numRow-i)*wireResistanceCol to each cell on its own: every cell sits between its row node and its column node, the
+   nodes of a row (column) are chained by wireResistanceRow (wireResistanceCol), the row drivers are at column 0 and the
+   column sense amps, a virtual ground, after the last row; rows that are not activated are driven to 0V.
+   The network is solved with a conjugate gradient preconditioned by the exact solution of every row and column line
+   (its tridiagonal factors are computed once per subArray), several right-hand sides at a time.
+   Linear cells superpose, so the current of each cell into its sense amp with only its row driven gives the effective
+   conductance of every cell once per subArray; with param->nonlinearIV the cell currents follow the current-ratio model
+   of NonlinearResistance and are solved by Newton iterations, per input vector for a parallel read */
+class CrossbarSolver {
+public:
+	CrossbarSolver(const MatrixView &weight, const MemCell &cell, const MonteCarloStream *variation=NULL, int replica=0);
+	
+	/* Functions */
+	static bool Enabled(const MemCell &cell);
+	static bool PerVector(const MemCell &cell);
+	bool TransferConductance(vector<double> &transfer) const;
+	bool ColumnConductance(const BitPlane &input, const int *vector, int numVector, double *columnG) const;
+	
+	/* Properties */
+	static const int BATCH = 16;	// right-hand sides solved together
+	int numRow, numCol;
+	
+private:
+	bool Solve(const double *drive, int numBatch, double *current) const;
+	void Multiply(const double *x, double *y, int numBatch, const double *g, size_t stride) const;
+	void Precondition(const double *r, double *z, int numBatch) const;
+	void Substitute(const double *r, double *z, const double *lowerLine, const double *inversePivotLine, double conductance, 
+					int length, size_t step, size_t factorStep, int numBatch) const;
+	bool ConjugateGradient(const double *b, double *x, int numBatch, const double *g, size_t stride) const;
+	double CellCurrent(double g0, double v, double *slope) const;
+	
+	double conductanceRow, conductanceCol;	// of one wire segment
+	double readVoltage, halfWriteVoltage, nonlinearity;
+	bool nonlinear;
+	vector<double> conductance;	// of each cell at the read voltage, including its access resistance
+	vector<double> lower, inversePivot;	// LU factors of the row and column lines (the preconditioner)
+};
+
+#endif /* CROSSBARSOLVER_H_ */
@@ -0,0 +1,236 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Param.h"
+#include "LayerCache.h"
+
+using namespace std;
+
+extern Param *param;
+
+// bump whenever a change of the models alters the layer results, so that old entries are not reused
+static const char *LAYER_CACHE_VERSION = "NeuroSim layer cache 3";
+static const char LAYER_CACHE_MAGIC[4] = {'N', 'S', 'L', 'C'};
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static void HashBytes(uint64_t *hash, const void *data, size_t size) {
+	const unsigned char *p = (const unsigned char *) data;
+	for (size_t i=0; i<size; i++) {
+		*hash = (*hash ^ p[i]) * FNV_PRIME;
+	}
+}
+
+static void HashDouble(uint64_t *hash, double value) {
+	HashBytes(hash, &value, sizeof(value));
+}
+
+static void HashVector(uint64_t *hash, const vector<double> &value) {
+	HashDouble(hash, value.size());
+	if (!value.empty()) {
+		HashBytes(hash, &value[0], value.size()*sizeof(double));
+	}
+}
+
+static void HashMatrix(uint64_t *hash, const vector<vector<double> > &value) {
+	HashDouble(hash, value.size());
+	for (int i=0; i<value.size(); i++) {
+		HashVector(hash, value[i]);
+	}
+}
+
+static bool HashFile(uint64_t *hash, const string &filename) {
+	ifstream infile(filename.c_str(), ios::binary);
+	if (!infile.good()) {
+		return false;
+	}
+	vector<char> block(1 << 20);
+	while (infile) {
+		infile.read(&block[0], block.size());
+		HashBytes(hash, &block[0], infile.gcount());
+	}
+	return true;
+}
+
+template <class T> static void WriteField(ostream &outfile, const T &value) {
+	outfile.write((const char *) &value, sizeof(value));
+}
+
+template <class T> static void ReadField(istream &infile, T *value) {
+	infile.read((char *) value, sizeof(*value));
+}
+
+// a LayerPerformance field by field, in the order of its declaration
+static void WriteLayer(ostream &outfile, const LayerPerformance &p) {
+	WriteField(outfile, p.readLatency);
+	WriteField(outfile, p.readDynamicEnergy);
+	WriteField(outfile, p.leakage);
+	WriteField(outfile, p.bufferLatency);
+	WriteField(outfile, p.bufferDynamicEnergy);
+	WriteField(outfile, p.icLatency);
+	WriteField(outfile, p.icDynamicEnergy);
+	WriteField(outfile, p.latencyADC);
+	WriteField(outfile, p.latencyAccum);
+	WriteField(outfile, p.latencyOther);
+	WriteField(outfile, p.energyADC);
+	WriteField(outfile, p.energyAccum);
+	WriteField(outfile, p.energyOther);
+	WriteField(outfile, p.sampling.numVector);
+	WriteField(outfile, p.sampling.numSampled);
+	for (int f=0; f<9; f++) {
+		WriteField(outfile, p.sampling.relativeError[f]);
+	}
+}
+
+static void ReadLayer(istream &infile, LayerPerformance *p) {
+	ReadField(infile, &p->readLatency);
+	ReadField(infile, &p->readDynamicEnergy);
+	ReadField(infile, &p->leakage);
+	ReadField(infile, &p->bufferLatency);
+	ReadField(infile, &p->bufferDynamicEnergy);
+	ReadField(infile, &p->icLatency);
+	ReadField(infile, &p->icDynamicEnergy);
+	ReadField(infile, &p->latencyADC);
+	ReadField(infile, &p->latencyAccum);
+	ReadField(infile, &p->latencyOther);
+	ReadField(infile, &p->energyADC);
+	ReadField(infile, &p->energyAccum);
+	ReadField(infile, &p->energyOther);
+	ReadField(infile, &p->sampling.numVector);
+	ReadField(infile, &p->sampling.numSampled);
+	for (int f=0; f<9; f++) {
+		ReadField(infile, &p->sampling.relativeError[f]);
+	}
+}
+
+static string LayerCachePath(const string &dir, uint64_t key) {
+	char name[32];
+	sprintf(name, "%016llx.layer", (unsigned long long) key);
+	return dir + "/" + name;
+}
+
+
+uint64_t LayerCacheKey(const ChipDesign &design, int layer, const string &weightfile, const string &inputfile) {
+	uint64_t hash = FNV_OFFSET;
+	HashBytes(&hash, LAYER_CACHE_VERSION, strlen(LAYER_CACHE_VERSION));
+	
+	string fields = param->Serialize();
+	HashBytes(&hash, fields.data(), fields.size());
+	
+	// floorplan, the layer result also depends on its neighbours (activation, pooling) --> the whole network
+	HashMatrix(&hash, design.netStructure);
+	HashDouble(&hash, design.synapseBit);
+	HashDouble(&hash, design.numBitInput);
+	HashDouble(&hash, design.cellBit);
+	HashDouble(&hash, design.numColPerSynapse);
+	HashDouble(&hash, design.numRowPerSynapse);
+	HashVector(&hash, vector<double>(design.markNM.begin(), design.markNM.end()));
+	double floorPlan[] = {design.maxPESizeNM, design.maxTileSizeCM, design.numPENM, design.desiredNumTileNM, design.desiredPESizeNM,
+						design.desiredNumTileCM, design.desiredTileSizeCM, design.desiredPESizeCM, (double) design.numTileRow, (double) design.numTileCol,
+						design.chipHeight, design.chipWidth, design.CMTileheight, design.CMTilewidth, design.NMTileheight, design.NMTilewidth};
+	HashBytes(&hash, floorPlan, sizeof(floorPlan));
+	HashMatrix(&hash, design.numTileEachLayer);
+	HashMatrix(&hash, design.utilizationEachLayer);
+	HashMatrix(&hash, design.speedUpEachLayer);
+	HashMatrix(&hash, design.tileLocaEachLayer);
+	HashDouble(&hash, layer);
+	
+	// the traces themselves, not their names or time stamps
+	if (!HashFile(&hash, weightfile) || !HashFile(&hash, inputfile)) {
+		cerr << "Error: cannot read the traces of layer " << layer+1 << " for the layer cache!" << endl;
+		exit(-1);
+	}
+	return hash;
+}
+
+
+bool LayerCacheLoad(const string &dir, uint64_t key, LayerPerformance *result) {
+	ifstream infile(LayerCachePath(dir, key).c_str(), ios::binary);
+	if (!infile.good()) {
+		return false;
+	}
+	char magic[4];
+	uint64_t storedKey;
+	infile.read(magic, sizeof(magic));
+	ReadField(infile, &storedKey);
+	if (!infile || memcmp(magic, LAYER_CACHE_MAGIC, sizeof(magic)) != 0 || storedKey != key) {
+		return false;
+	}
+	LayerPerformance value;
+	ReadLayer(infile, &value);
+	if (!infile) {
+		return false;	// truncated entry, simulate the layer again
+	}
+	*result = value;
+	return true;
+}
+
+
+bool LayerCacheStore(const string &dir, uint64_t key, const LayerPerformance &result) {
+	if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+		cerr << "Warning: cannot create the layer cache directory " << dir << "!" << endl;
+		return false;
+	}
+	// write to a private file first and rename it, so that concurrent runs never see a partial entry
+	string path = LayerCachePath(dir, key);
+	ostringstream temp;
+	temp << path << ".tmp" << getpid();
+	ofstream outfile(temp.str().c_str(), ios::binary);
+	outfile.write(LAYER_CACHE_MAGIC, sizeof(LAYER_CACHE_MAGIC));
+	WriteField(outfile, key);
+	WriteLayer(outfile, result);
+	outfile.close();
+	if (!outfile || rename(temp.str().c_str(), path.c_str()) != 0) {
+		cerr << "Warning: cannot write the layer cache entry " << path << "!" << endl;
+		remove(temp.str().c_str());
+		return false;
+	}
+	return true;
+}
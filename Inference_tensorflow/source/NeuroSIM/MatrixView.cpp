@@ -0,0 +1,87 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "MatrixView.h"
+
+using namespace std;
+
+MatrixView::MatrixView(): data(NULL), conductance(NULL), numRow(0), numCol(0), ld(0), rowStart(0), blockRow(INT_MAX), blockStride(0), origin(NULL) {}
+
+MatrixView::MatrixView(const uint8_t *_data, const double *_conductance, int _numRow, int _numCol, size_t _ld):
+data(_data), conductance(_conductance), numRow(_numRow), numCol(_numCol), ld(_ld), rowStart(0), blockRow(INT_MAX), blockStride(0), origin(_data) {}
+
+MatrixView MatrixView::Block(int positionRow, int positionCol, int _numRow, int _numCol) const {
+	MatrixView view(*this);
+	view.data = data + positionCol;
+	view.rowStart = rowStart + positionRow;
+	view.numRow = _numRow;
+	view.numCol = _numCol;
+	return view;
+}
+
+MatrixView MatrixView::Reshape(int positionRow, int positionCol, int _numRow, int _numCol, int numPE, int weightMatrixRow) const {
+	// logical rows k*_numRow+i (k<numPE) map to rows positionRow+k*weightMatrixRow+i of this view
+	if (blockRow != INT_MAX) {
+		puts("Reshape of a reshaped view is not supported");
+		exit(-1);
+	}
+	MatrixView view(*this);
+	view.data = Row(positionRow) + positionCol;
+	view.rowStart = 0;
+	view.numRow = _numRow*numPE;
+	view.numCol = _numCol;
+	view.blockRow = _numRow;
+	view.blockStride = weightMatrixRow;
+	return view;
+}
+
+void WeightMatrix::SetConductanceRange(int cellBit, double maxConductance, double minConductance) {
+	// levels evenly spaced between minConductance and maxConductance
+	if (cellBit < 1 || cellBit > 8) {
+		cerr << "Error: cellBit " << cellBit << " does not fit the one-byte cell codes of the weights!" << endl;
+		exit(-1);
+	}
+	int cellrange = 1 << cellBit;
+	conductance.resize(cellrange);
+	for (int code=0; code<cellrange; code++) {
+		conductance[code] = (double) code/(cellrange-1) * (maxConductance-minConductance) + minConductance;
+	}
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef MATRIXVIEW_H_
+#define MATRIXVIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <climits>
+#include <vector>
+
+using namespace std;
+
+/* Read-only window on a row-major matrix of cell codes, conductance[code] is the conductance of the cell. Logical row r of the
+   view is source row ((rowStart+r)/blockRow)*blockStride + (rowStart+r)%blockRow,
+   so the novel-mapping reshape (numPE blocks of rows stacked on top of each other)
+   is expressed without copying; for a plain window blockRow is INT_MAX */
+class MatrixView {
+public:
+	MatrixView();
+	MatrixView(const uint8_t *_data, const double *_conductance, int _numRow, int _numCol, size_t _ld);
+	
+	/* Functions */
+	MatrixView Block(int positionRow, int positionCol, int _numRow, int _numCol) const;
+	MatrixView Reshape(int positionRow, int positionCol, int _numRow, int _numCol, int numPE, int weightMatrixRow) const;
+	
+	const uint8_t *Row(int row) const {
+		int r = rowStart + row;
+		return data + ((size_t)(r/blockRow)*blockStride + r%blockRow)*ld;
+	}
+	double operator()(int row, int col) const {
+		return conductance[Row(row)[col]];
+	}
+	uint64_t CellIndex(int row, int col) const {
+		return Row(row) + col - origin;
+	}
+	
+	/* Properties */
+	const uint8_t *data;	/* element (0, 0) of the first block */
+	const double *conductance;	/* conductance of each cell code */
+	int numRow;
+	int numCol;
+	size_t ld;				/* distance between source rows, in elements */
+	int rowStart;			/* logical row offset inside the block structure */
+	int blockRow;			/* rows per reshaped block */
+	size_t blockStride;		/* source rows between two reshaped blocks */
+	const uint8_t *origin;	/* element (0, 0) of the whole matrix, the offset of a cell from it identifies the cell */
+};
+
+/* Contiguous row-major storage of a layer's weights as cell codes (0 .. 2^cellBit-1, numColPerSynapse cells per synapse,
+   most significant first), one byte per cell; the conductances of the 2^cellBit levels are kept in a table */
+class WeightMatrix {
+public:
+	WeightMatrix(): numRow(0), numCol(0) {}
+	
+	/* Functions */
+	void SetConductanceRange(int cellBit, double maxConductance, double minConductance);
+	
+	MatrixView View() const {
+		return MatrixView(data.empty()? NULL : &data[0], conductance.empty()? NULL : &conductance[0], numRow, numCol, numCol);
+	}
+	
+	/* Properties */
+	int numRow;
+	int numCol;
+	vector<uint8_t> data;
+	vector<double> conductance;
+};
+
+#endif /* MATRIXVIEW_H_ */
@@ -0,0 +1,107 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include "MonteCarlo.h"
+#include "Param.h"
+
+using namespace std;
+
+extern Param *param;
+
+// tags that separate the streams of the different effects under one key
+enum { STREAM_STUCK = 1, STREAM_VARIATION = 2, STREAM_READNOISE = 3 };
+
+// SplitMix64 finalizer applied to the key and the counter: a counter-based generator, any draw can be made independently
+uint64_t MonteCarloHash(uint64_t key, uint64_t counter) {
+	uint64_t x = key ^ (counter * 0x9E3779B97F4A7C15ULL + 0x632BE59BD9B4E019ULL);
+	for (int round=0; round<2; round++) {
+		x ^= x >> 30;
+		x *= 0xBF58476D1CE4E5B9ULL;
+		x ^= x >> 27;
+		x *= 0x94D049BB133111EBULL;
+		x ^= x >> 31;
+	}
+	return x;
+}
+
+// uniform in (0, 1)
+double MonteCarloUniform(uint64_t key, uint64_t counter) {
+	return ((MonteCarloHash(key, counter) >> 11) + 0.5) * (1.0/9007199254740992.0);
+}
+
+// standard normal (Box-Muller on two independent draws of the same counter)
+double MonteCarloNormal(uint64_t key, uint64_t counter) {
+	double u1 = MonteCarloUniform(key, 2*counter);
+	double u2 = MonteCarloUniform(key, 2*counter+1);
+	return sqrt(-2*log(u1)) * cos(2*M_PI*u2);
+}
+
+MonteCarloStream MonteCarloStreamOf(int trial, int layer) {
+	MonteCarloStream stream;
+	stream.key = MonteCarloHash(MonteCarloHash(param->monteCarloSeed, trial), layer);
+	stream.numColumnRead = stream.numLevelError = stream.sumLevelError = 0;
+	return stream;
+}
+
+// counter of a cell (or column) of one replica of the subArray holding it, replica 0 keeps the position of the cell
+uint64_t MonteCarloCellOf(int replica, uint64_t cell) {
+	return replica? MonteCarloHash(replica, cell) : cell;
+}
+
+// conductance of one programmed cell in this trial: stuck at the off/on state with the stuck-at rates, otherwise
+// scaled by a device-to-device variation of relative sigma param->deviceVariation
+double MonteCarloCellConductance(const MonteCarloStream &stream, uint64_t cell, double conductance) {
+	double u = MonteCarloUniform(stream.key + STREAM_STUCK, cell);
+	if (u < param->stuckAtOffRate) {
+		return param->minConductance;
+	}
+	if (u < param->stuckAtOffRate + param->stuckAtOnRate) {
+		return param->maxConductance;
+	}
+	if (param->deviceVariation > 0) {
+		conductance *= max(0.0, 1 + param->deviceVariation * MonteCarloNormal(stream.key + STREAM_VARIATION, cell));
+	}
+	return conductance;
+}
+
+// standard normal draw of the read noise of one column for one input vector
+double MonteCarloReadNoise(const MonteCarloStream &stream, uint64_t column, uint64_t inputIndex) {
+	return MonteCarloNormal(MonteCarloHash(stream.key + STREAM_READNOISE, column), inputIndex);
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef MONTECARLO_H_
+#define MONTECARLO_H_
+
+#include <stdint.h>
+
+/* Monte Carlo device variation and read noise (param->monteCarloTrials > 0). Random numbers come from a counter-based
+   generator: each value is a hash of a stream key and a counter (the index of the cell, column or input vector it
+   perturbs), so the draws do not depend on the order of evaluation and the trials are reproducible for any # of threads.
+   A cell is identified by its position in the layer weight matrix and the replica of the subArray holding it: the
+   subArrays that duplicate a block of the weights (arrayDup / speedUp) are separate devices and draw their own values,
+   see MonteCarloCellOf. When the whole matrix is duplicated the copies only share out the input vectors, and are modeled
+   by one copy (replica 0) as for the latency */
+
+/* Random streams of one trial of one layer, and the ADC output error accumulated while evaluating it */
+struct MonteCarloStream {
+	uint64_t key;
+	long long numColumnRead;	// # of column conversions of the multilevel sense amp
+	long long numLevelError;	// # of conversions whose output level differs from the nominal one
+	long long sumLevelError;	// sum of the absolute level differences
+};
+
+/*** Functions ***/
+uint64_t MonteCarloHash(uint64_t key, uint64_t counter);
+double MonteCarloUniform(uint64_t key, uint64_t counter);
+double MonteCarloNormal(uint64_t key, uint64_t counter);
+MonteCarloStream MonteCarloStreamOf(int trial, int layer);
+uint64_t MonteCarloCellOf(int replica, uint64_t cell);
+double MonteCarloCellConductance(const MonteCarloStream &stream, uint64_t cell, double conductance);
+double MonteCarloReadNoise(const MonteCarloStream &stream, uint64_t column, uint64_t inputIndex);
+
+#endif /* MONTECARLO_H_ */
@@ -65,6 +65,7 @@ public:
 	void CalculatePower(const vector<double> &columnResistance, double numRead);
 	double GetColumnLatency(double columnRes);
 	double GetColumnPower(double columnRes);
+	int GetColumnLevel(double columnRes) const;
 
 	/* Properties */
 	bool initialized;		/* Initialization flag */
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef NEUROSIM_H_
+#define NEUROSIM_H_
+
+#include <string>
+#include <vector>
+#include "BitPlane.h"
+#include "MatrixView.h"
+#include "Chip.h"
+
+using namespace std;
+
+/* Everything the chip pipeline (ChipDesignInitialize -> ChipFloorPlan in NeuroSimFloorPlan, ChipInitialize -> ChipCalculateArea
+   in NeuroSimInitialize) produces before the layers are evaluated, so that one initialized chip can be evaluated many times.
+   param, tech and cell are process-wide: initializing another design re-targets them */
+struct ChipDesign {
+	vector<vector<double> > netStructure;
+	int synapseBit, numBitInput, cellBit, numColPerSynapse, numRowPerSynapse;	// precision the chip was built for
+	
+	vector<int> markNM;
+	double maxPESizeNM, maxTileSizeCM, numPENM;
+	double desiredNumTileNM, desiredPESizeNM, desiredNumTileCM, desiredTileSizeCM, desiredPESizeCM;
+	int numTileRow, numTileCol;
+	vector<vector<double> > numTileEachLayer;
+	vector<vector<double> > utilizationEachLayer;
+	vector<vector<double> > speedUpEachLayer;
+	vector<vector<double> > tileLocaEachLayer;
+	
+	double chipHeight, chipWidth, CMTileheight, CMTilewidth, NMTileheight, NMTilewidth;
+	vector<double> chipAreaResults;		// chip area, IC, ADC, accumulation, other
+	
+	ChipContext modules;	// initialized circuit modules, every evaluation works on a copy
+};
+
+/* Results of one layer: the outputs of ChipCalculatePerformance and the accuracy of its sampled input vectors */
+struct LayerPerformance {
+	double readLatency, readDynamicEnergy, leakage;		// leakage: of one tile of the layer
+	double bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy;
+	double latencyADC, latencyAccum, latencyOther, energyADC, energyAccum, energyOther;
+	SamplingStatistics sampling;		// kept with the layer result, so that it is reported for layers loaded from the layer cache too
+};
+
+/* Results of one inference, per layer and summed over the chip */
+struct ChipPerformance {
+	vector<LayerPerformance> layer;
+	vector<double> layerLeakageEnergy;
+	
+	double readLatency, readDynamicEnergy, leakageEnergy, leakage;
+	double bufferLatency, bufferDynamicEnergy, icLatency, icDynamicEnergy;
+	double latencyADC, latencyAccum, latencyOther, energyADC, energyAccum, energyOther;
+	double numComputation;
+	SamplingStatistics sampling;		// over all layers of this evaluation (param->sampleError > 0)
+};
+
+/*** Functions ***/
+vector<vector<double> > getNetStructure(const string &inputfile);
+void NeuroSimFloorPlan(const vector<vector<double> > &netStructure, int synapseBit, int numBitInput, ChipDesign *design);
+void NeuroSimInitialize(ChipDesign *design);
+void NeuroSimFree(ChipDesign *design);
+void NeuroSimLoadPrecision(const ChipDesign &design);
+void NeuroSimCalculateLayer(const ChipDesign &design, int layer, const WeightMatrix &weight, const BitPlane &input, LayerPerformance *result, MonteCarloStream *variation=NULL);
+ChipPerformance NeuroSimCalculatePerformance(const ChipDesign &design, const vector<WeightMatrix> &weight, const vector<BitPlane> &input);
+ChipPerformance NeuroSimSummarize(const ChipDesign &design, const vector<LayerPerformance> &layerPerformance);
+void NeuroSimPrintFloorPlan(const ChipDesign &design);
+void NeuroSimPrintPerformance(const ChipDesign &design, const ChipPerformance &performance);
+void NeuroSimPrintComparison(const ChipDesign &design, const ChipPerformance &exact, const ChipPerformance &estimate);
+void NeuroSimPrintMonteCarlo(const vector<ChipPerformance> &trials, const vector<vector<MonteCarloStream> > &streams);
+
+#endif /* NEUROSIM_H_ */
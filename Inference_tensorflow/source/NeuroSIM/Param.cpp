@@ -46,6 +46,8 @@
 #include "math.h"
 #include "Param.h"
 
+using namespace std;
+
 Param::Param() {
 	
 	operationmode = 2;     		// 1: conventionalSequential (Use several multi-bit RRAM as one synapse)
@@ -87,6 +89,22 @@ Param::Param() {
 								
 	numRowSubArray = 64;       // # of rows in single subArray
 	numColSubArray = 64;       // # of columns in single subArray
+	numVectorPerChunk = 4096;  // # of input vectors streamed through a subArray at a time (bounds the input copies and result cache of large layers)
+	floorPlanSearch = 0;       // 0: tile and PE sizes halve from the maximum
+								// 1: lay out every (tile, PE) pair of multiples of the subArray size (PE sizes dividing the tile size), in parallel
+	floorPlanMetric = 0;       // score of a floorplan in the floorPlanSearch = 1 search, 0: memory utilization of the whole chip
+								// 1: fewest tiles (ties broken by utilization)
+	sampleError = 0;           // 0: simulate every input vector
+								// >0: sample the input vectors of each subArray until the 95% confidence interval is within this relative error
+	fastEstimate = 0;          // 0: simulate the input vectors (every one, or sampled with sampleError)
+								// 1: analytical estimate, each subArray is evaluated once for the expected input vector
+								// 2: (main) evaluate both and report the error of the estimate
+	irDropSolver = 0;          // 0: wire resistance added to each cell by its position in the subArray
+								// 1: nodal analysis of the subArray's wires and cells (CrossbarSolver), eNVM only
+	readResultCache = 2;       // result cache of the subArray read per input vector, keyed by the exact column resistances
+								// 0: off, 1: on, 2: SRAM subArrays only (eNVM column resistances rarely repeat exactly)
+	monteCarloTrials = 0;      // # of Monte Carlo trials of device variation, stuck-at faults and read noise run after the nominal evaluation (main)
+	monteCarloSeed = 0;        // seed of the counter-based random streams of the trials
 	
 	heightInFeatureSizeSRAM = 8;                  // SRAM Cell height in feature size
 	widthInFeatureSizeSRAM = 20;                     // SRAM Cell width in feature size
@@ -112,11 +130,12 @@ Param::Param() {
 	temp = 301;                  // Temperature (K)
 	technode = 32;               // Technology
 	wireWidth = 40;                                    // wireWidth of the cell for Accuracy calculation
-	readNoise = 0.15;	                               // Sigma of read noise in gaussian distribution
+	readNoise = 0.15;	                               // Sigma of read noise in gaussian distribution (relative to the cell conductance, Monte Carlo trials only)
+	deviceVariation = 0;         // Sigma of the device-to-device conductance variation (relative, Monte Carlo trials only)
+	stuckAtOnRate = 0;           // Fraction of cells stuck at the on state (Monte Carlo trials only)
+	stuckAtOffRate = 0;          // Fraction of cells stuck at the off state (Monte Carlo trials only)
 	resistanceOn = 100e3;        // Ron resistance at Vr in the reported measurement data (need to recalculate below if considering the nonlinearity)
 	resistanceOff = 10e6;        // Roff resistance at Vr in the reported measurement dat (need to recalculate below if considering the nonlinearity)
-	maxConductance = (double) 1/resistanceOn;
-	minConductance = (double) 1/resistanceOff;
 	maxNumLevelLTP = 97;	                            // Maximum number of conductance states during LTP or weight increase
 	maxNumLevelLTD = 100;	                            // Maximum number of conductance states during LTD or weight decrease
 	readVoltage = 0.5;	                                // On-chip read voltage for memory cell
@@ -139,6 +158,57 @@ Param::Param() {
 	levelOutput = 16;             // # of levels of the multilevelSenseAmp output 
 	cellBit = 1;                 // precision of memory device 
 	
+	Update();
+}
+
+
+/* Recompute the fields derived from the ones above, call again after changing any of them (e.g. through SetValue) */
+void Param::Update() {
+	
+	if (memcelltype < 1 || memcelltype > 3 || accesstype < 1 || accesstype > 4 || transistortype < 1 || transistortype > 3 || deviceroadmap < 1 || deviceroadmap > 2) {
+		cerr << "Error: memcelltype, accesstype, transistortype or deviceroadmap is out of range!" << endl;
+		exit(-1);
+	}
+	if (floorPlanSearch < 0 || floorPlanSearch > 1) {
+		cerr << "Error: floorPlanSearch must be 0 (halving) or 1 (every multiple of the subArray size)!" << endl;
+		exit(-1);
+	}
+	if (floorPlanMetric < 0 || floorPlanMetric > 1) {
+		cerr << "Error: floorPlanMetric must be 0 (chip utilization) or 1 (fewest tiles)!" << endl;
+		exit(-1);
+	}
+	if (fastEstimate < 0 || fastEstimate > 2) {
+		cerr << "Error: fastEstimate must be 0 (simulate), 1 (analytical estimate) or 2 (compare both)!" << endl;
+		exit(-1);
+	}
+	if (fastEstimate && sampleError > 0) {
+		cerr << "Error: sampleError and fastEstimate cannot be used together!" << endl;
+		exit(-1);
+	}
+	if (readResultCache < 0 || readResultCache > 2) {
+		cerr << "Error: readResultCache must be 0 (off), 1 (on) or 2 (SRAM only)!" << endl;
+		exit(-1);
+	}
+	if (irDropSolver < 0 || irDropSolver > 1) {
+		cerr << "Error: irDropSolver must be 0 (per-cell wire resistance) or 1 (nodal solver)!" << endl;
+		exit(-1);
+	}
+	if (monteCarloTrials < 0 || readNoise < 0 || deviceVariation < 0 || stuckAtOnRate < 0 || stuckAtOffRate < 0 || stuckAtOnRate + stuckAtOffRate > 1) {
+		cerr << "Error: monteCarloTrials, readNoise, deviceVariation and the stuck-at rates must not be negative, the stuck-at rates must sum to at most 1!" << endl;
+		exit(-1);
+	}
+	if (sampleError < 0 || sampleError >= 1) {
+		cerr << "Error: sampleError must be 0 (exact) or a relative error between 0 and 1!" << endl;
+		exit(-1);
+	}
+	if (numRowSubArray <= 0 || numColSubArray <= 0 || numVectorPerChunk <= 0 || numColMuxed <= 0 || numWriteColMuxed <= 0 || levelOutput <= 0 || cellBit <= 0) {
+		cerr << "Error: subArray size, numVectorPerChunk, numColMuxed, numWriteColMuxed, levelOutput and cellBit must be positive!" << endl;
+		exit(-1);
+	}
+	
+	maxConductance = (double) 1/resistanceOn;
+	minConductance = (double) 1/resistanceOff;
+	
 	if (memcelltype == 1) {
 		cellBit = 1;             // force cellBit = 1 for all SRAM cases
 	} 
@@ -150,7 +220,7 @@ Param::Param() {
 		case 2:	    conventionalParallel = 1;           break;     
 		case 1:	    conventionalSequential = 1;         break;    
 		case -1:	break;
-		default:	exit(-1);
+		default:	cerr << "Error: operationmode " << operationmode << " is not supported!" << endl; exit(-1);
 	}
 	
 	/*** parallel read ***/
@@ -171,7 +241,7 @@ Param::Param() {
 		case 22:	AR = 2.00; Rho = 5.41e-8; break;
 		case 14:	AR = 2.10; Rho = 7.43e-8; break;
 		case -1:	break;	// Ignore wire resistance or user define
-		default:	exit(-1); puts("Wire width out of range"); 
+		default:	cerr << "Error: wireWidth " << wireWidth << " is out of range!" << endl; exit(-1);
 	}
 	
 	if (memcelltype == 1) {
@@ -200,3 +270,180 @@ Param::Param() {
 	
 }
 
+
+/* Fields that can be set by name (config file / --set), the derived ones are recomputed by Update */
+#define PARAM_FIELDS(X) \
+	X(operationmode) X(memcelltype) X(accesstype) X(transistortype) X(deviceroadmap) \
+	X(globalBufferType) X(tileBufferType) X(peBufferType) X(chipActivation) X(reLu) X(novelMapping) \
+	X(numRowSubArray) X(numColSubArray) X(numVectorPerChunk) X(floorPlanSearch) X(floorPlanMetric) X(sampleError) X(fastEstimate) X(irDropSolver) X(readResultCache) \
+	X(monteCarloTrials) X(monteCarloSeed) X(deviceVariation) X(stuckAtOnRate) X(stuckAtOffRate) \
+	X(heightInFeatureSizeSRAM) X(widthInFeatureSizeSRAM) X(widthSRAMCellNMOS) X(widthSRAMCellPMOS) X(widthAccessCMOS) X(minSenseVoltage) \
+	X(heightInFeatureSize1T1R) X(widthInFeatureSize1T1R) X(heightInFeatureSizeCrossbar) X(widthInFeatureSizeCrossbar) \
+	X(relaxArrayCellHeight) X(relaxArrayCellWidth) \
+	X(globalBusDelayTolerance) X(localBusDelayTolerance) X(treeFoldedRatio) X(maxGlobalBusWidth) \
+	X(clkFreq) X(featuresize) X(temp) X(technode) X(wireWidth) X(readNoise) \
+	X(resistanceOn) X(resistanceOff) X(maxNumLevelLTP) X(maxNumLevelLTD) \
+	X(readVoltage) X(readPulseWidth) X(accessVoltage) X(resistanceAccess) X(multipleCells) \
+	X(nonlinearIV) X(nonlinearity) X(writeVoltage) X(writePulseWidth) X(numWritePulse) \
+	X(neuro) X(multifunctional) X(parallelWrite) X(numlut) X(numColMuxed) X(numWriteColMuxed) \
+	X(levelOutput) X(cellBit)
+
+/* Assign a value to a field of its type, reports and returns false if it does not fit: int fields take whole numbers only,
+   bool fields 0 or 1 */
+static bool AssignField(const std::string &name, double value, double &field) {
+	field = value;
+	return true;
+}
+
+static bool AssignField(const std::string &name, double value, int &field) {
+	if (value != floor(value) || value < -2147483648.0 || value > 2147483647.0) {
+		cerr << "Error: " << name << " must be an integer, got " << value << "!" << endl;
+		return false;
+	}
+	field = value;
+	return true;
+}
+
+static bool AssignField(const std::string &name, double value, bool &field) {
+	if (value != 0 && value != 1) {
+		cerr << "Error: " << name << " must be 0 or 1 (false or true), got " << value << "!" << endl;
+		return false;
+	}
+	field = value;
+	return true;
+}
+
+
+/* Whether name is a user-defined field (the fields derived in Update and the precision set by the wrapper are not settable) */
+bool Param::HasField(const std::string &name) const {
+	
+#define PARAM_FIELD(field) if (name == #field) { return true; }
+	PARAM_FIELDS(PARAM_FIELD)
+#undef PARAM_FIELD
+	
+	return false;
+}
+
+
+/* Set a user-defined field by name, returns false if there is no such field or (reported) if the value does not fit its type */
+bool Param::SetValue(const std::string &name, double value) {
+	
+#define PARAM_FIELD(field) if (name == #field) { return AssignField(name, value, field); }
+	PARAM_FIELDS(PARAM_FIELD)
+#undef PARAM_FIELD
+	
+	return false;
+}
+
+
+/* The settable fields as "name=value" lines, with enough digits to read them back exactly */
+string Param::Serialize() const {
+	ostringstream out;
+	out.precision(17);
+#define PARAM_FIELD(field) out << #field << "=" << (double) field << "\n";
+	PARAM_FIELDS(PARAM_FIELD)
+#undef PARAM_FIELD
+	return out.str();
+}
+
+
+/* Set a field by name from text (a number, or true/false), reports and returns false if the name or the value is invalid.
+   Call Update once all fields are set */
+bool Param::Override(const string &name, const string &value) {
+	
+	double number;
+	if (value == "true") {
+		number = 1;
+	} else if (value == "false") {
+		number = 0;
+	} else {
+		char *end;
+		number = strtod(value.c_str(), &end);
+		if (value.empty() || *end != '\0') {
+			cerr << "Error: '" << value << "' is not a valid value for " << name << "!" << endl;
+			return false;
+		}
+	}
+	if (!HasField(name)) {
+		cerr << "Error: unknown parameter '" << name << "'!" << endl;
+		return false;
+	}
+	return SetValue(name, number);
+}
+
+
+/* Load "name = value" lines (INI style: '#' or ';' starts a comment, [section] headers are ignored) over the current values.
+   Call Update once all fields are set */
+bool Param::LoadConfig(const string &configfile) {
+	
+	ifstream infile(configfile.c_str());
+	if (!infile.good()) {
+		cerr << "Error: the config file " << configfile << " cannot be opened!" << endl;
+		return false;
+	}
+	string inputline;
+	int lineNumber = 0;
+	while (getline(infile, inputline, '\n')) {
+		lineNumber++;
+		inputline = inputline.substr(0, inputline.find_first_of("#;"));
+		inputline.erase(0, inputline.find_first_not_of(" \t\r"));
+		inputline.erase(inputline.find_last_not_of(" \t\r")+1);
+		if (inputline.empty() || inputline[0] == '[') {
+			continue;
+		}
+		size_t eq = inputline.find('=');
+		if (eq == string::npos) {
+			cerr << "Error: expected 'name = value' at line " << lineNumber << " of " << configfile << "!" << endl;
+			return false;
+		}
+		string name = inputline.substr(0, eq);
+		string value = inputline.substr(eq+1);
+		name.erase(name.find_last_not_of(" \t")+1);
+		value.erase(0, value.find_first_not_of(" \t"));
+		if (!Override(name, value)) {
+			cerr << "Error: at line " << lineNumber << " of " << configfile << endl;
+			return false;
+		}
+	}
+	infile.close();
+	return true;
+}
+
+
+/* Apply the options "--config file.ini" and "--set name=value" (in the order given, later ones win), take the directory
+   of the per-layer result cache from "--cache dir" and remove them from the command line, so that the remaining arguments keep their positions */
+void Param::ParseArguments(int *argc, char *argv[]) {
+	
+	int numArg = 1;
+	for (int i=1; i<*argc; i++) {
+		string arg = argv[i];
+		if (arg == "--config" || arg == "--set" || arg == "--cache") {
+			if (i+1 >= *argc) {
+				cerr << "Error: " << arg << " needs a value!" << endl;
+				exit(1);
+			}
+			string value = argv[++i];
+			if (arg == "--config") {
+				if (!LoadConfig(value)) {
+					exit(1);
+				}
+			} else if (arg == "--cache") {
+				layerCacheDir = value;
+			} else {
+				size_t eq = value.find('=');
+				if (eq == string::npos) {
+					cerr << "Error: expected --set name=value, got '" << value << "'!" << endl;
+					exit(1);
+				}
+				if (!Override(value.substr(0, eq), value.substr(eq+1))) {
+					exit(1);
+				}
+			}
+		} else {
+			argv[numArg++] = argv[i];
+		}
+	}
+	*argc = numArg;
+	argv[numArg] = NULL;
+	Update();
+}
@@ -39,9 +39,18 @@
 #ifndef PARAM_H_
 #define PARAM_H_
 
+#include <string>
+
 class Param {
 public:
 	Param();
+	void Update();
+	bool HasField(const std::string &name) const;
+	bool SetValue(const std::string &name, double value);
+	bool Override(const std::string &name, const std::string &value);
+	bool LoadConfig(const std::string &configfile);
+	void ParseArguments(int *argc, char *argv[]);
+	std::string Serialize() const;
 
 	int operationmode, memcelltype, accesstype, transistortype, deviceroadmap;      		
 	
@@ -65,11 +74,22 @@ public:
 	int neuro, multifunctional, parallelWrite, parallelRead;
 	int numlut, numColMuxed, numWriteColMuxed, levelOutput, avgWeightBit, numBitInput;
 	int numRowSubArray, numColSubArray;
+	int numVectorPerChunk;
+	int floorPlanSearch;
+	int floorPlanMetric;
+	double sampleError;
+	int fastEstimate;
+	int irDropSolver;
+	int readResultCache;
+	int monteCarloTrials, monteCarloSeed;
+	double deviceVariation, stuckAtOnRate, stuckAtOffRate;
 	int cellBit, synapseBit;
 	
 	int XNORparallelMode, XNORsequentialMode, BNNparallelMode, BNNsequentialMode, conventionalParallel, conventionalSequential; 
 	int numRowPerSynapse, numColPerSynapse;
 	double AR, Rho, wireLengthRow, wireLengthCol, unitLengthWireResistance, wireResistanceRow, wireResistanceCol;
+	
+	std::string layerCacheDir;	// directory of the on-disk per-layer result cache (--cache), empty: disabled
 };
 
 #endif
\ No newline at end of file
@@ -42,20 +42,101 @@
 #include "Technology.h"
 #include "MemCell.h"
 #include "SubArray.h"
- 
+#include "AdderTree.h"
+#include "Bus.h"
+#include "DFF.h"
+#include "BitPlane.h"
+#include "MatrixView.h"
+#include "CrossbarSolver.h"
+
+struct MonteCarloStream;
+
+/*** Buffers of the per-input-vector loop, sized on first use and reused afterwards ***/
+struct ProcessingUnitScratch {
+	vector<double> input;
+	vector<double> columnG;
+	vector<double> columnResistance;
+	vector<double> columnVariance;		// Monte Carlo trials only
+	vector<double> nominalG;
+	vector<double> nominalResistance;
+	vector<double> solvedG;			// IR drop solver per input vector only, CrossbarSolver::BATCH vectors
+};
+
+/*** Accuracy of the sampling mode (param->sampleError > 0), gathered over the subArray chunks of one evaluation ***/
+struct SamplingStatistics {
+	long long numVector, numSampled;	// input vectors estimated and input vectors actually simulated
+	double relativeError[9];	// largest 95% confidence half-width over its estimate, per field of SubArray::ReadResult
+};
+
+/*** State of one evaluation of a layer, passed down to its subArrays ***/
+struct EvaluationState {
+	MonteCarloStream *variation;	// random streams of the Monte Carlo trial, NULL: nominal devices
+	SamplingStatistics *sampling;	// accuracy of the sampled chunks (param->sampleError > 0), NULL: not gathered
+	int replica;	// copy of a duplicated subArray being read, its devices draw their own variation (see MonteCarloCellOf)
+};
+
+/*** Circuit modules of the ProcessingUnit level, private to each thread ***/
+struct ProcessingUnitContext {
+	AdderTree *adderTree;
+	Bus *busInput;
+	Bus *busOutput;
+	DFF *bufferInput;
+	DFF *bufferOutput;
+	ProcessingUnitScratch *scratch;
+};
+
+/*** Read state of one subArray that only depends on its weights, built once and shared by all of its input vectors ***/
+class SubArrayConductance {
+public:
+	SubArrayConductance(const MatrixView &weight, MemCell& cell, const EvaluationState &evaluation);
+	~SubArrayConductance();
+
+	/* Properties */
+	vector<double> cellConductance;	// see GetCellConductance
+	vector<double> nominalConductance;	// of the nominal devices in a Monte Carlo trial (ADC output errors are counted against them), empty otherwise
+	CrossbarSolver *solver;	// IR drop solver run per input vector for nonlinear cells read in parallel (CrossbarSolver::PerVector), NULL otherwise
+
+private:
+	SubArrayConductance(const SubArrayConductance &);	// owns the solver, not copyable
+	SubArrayConductance &operator=(const SubArrayConductance &);
+};
+
 /*** Functions ***/
+ProcessingUnitContext ProcessingUnitSaveContext();
+void ProcessingUnitLoadContext(const ProcessingUnitContext &context);
+ProcessingUnitContext ProcessingUnitCloneContext(const ProcessingUnitContext &context);
+void ProcessingUnitFreeContext(ProcessingUnitContext &context);
 void ProcessingUnitInitialize(SubArray *& subArray, InputParameter& inputParameter, Technology& tech, MemCell& cell, int subArrayRowSize, int _numSubArrayCol);
 vector<double> ProcessingUnitCalculateArea(SubArray *subArray, int numSubArrayRow, int numSubArrayCol, double *height, double *width, double *bufferArea);
-double ProcessingUnitCalculatePerformance(SubArray *subArray, const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, const vector<vector<double> > &inputVector, 
+void ProcessingUnitCalculatePerformance(SubArray *subArray, const MatrixView &newMemory, const MatrixView &oldMemory, const BitPlane &inputVector, 
 										int arrayDupRow, int arrayDupCol, int numSubArrayRow, int numSubArrayCol, int weightMatrixRow, int weightMatrixCol, 
 										int numInVector, MemCell& cell, double *readLatency, double *readDynamicEnergy, double *leakage, 
 										double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
-										double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther);
+										double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther,
+										const EvaluationState &evaluation);
 
-vector<vector<double> > CopySubArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol);
-vector<vector<double> > CopySubInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow);
-vector<double> GetInputVector(const vector<vector<double> > &input, int numInput, double *activityRowRead);
-vector<double> GetColumnResistance(const vector<double> &input, const vector<vector<double> > &weight, MemCell& cell, bool parallelRead, double resCellAccess);
+void SubArrayCalculateChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const SubArrayConductance &conductance,
+							const EvaluationState &evaluation, MemCell& cell, vector<SubArray::ReadResult> &result);
+void SubArraySampleChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const vector<double> &cellConductance, 
+							const vector<double> &nominalConductance, const CrossbarSolver *solver, const EvaluationState &evaluation, MemCell& cell, 
+							SubArray::ReadResult *result);
+void SubArrayEstimateChunk(SubArray *subArray, const BitPlane &subArrayInput, const MatrixView &subArrayMemory, const vector<double> &cellConductance, 
+							MemCell& cell, SubArray::ReadResult *result);
+void SubArrayEvaluate(SubArray *subArray, const BitPlane &subArrayInput, const int *index, int numIndex, const MatrixView &subArrayMemory, 
+							const vector<double> &cellConductance, const vector<double> &nominalConductance, const CrossbarSolver *solver, 
+							const EvaluationState &evaluation, MemCell& cell, SubArray::ReadResult *result);
+void SubArrayCalculateVectors(SubArray *subArray, ProcessingUnitScratch &buffer, const BitPlane &subArrayInput, const int *index, int begin, int end, 
+							const MatrixView &subArrayMemory, const vector<double> &cellConductance, const vector<double> &nominalConductance, 
+							const CrossbarSolver *solver, const EvaluationState &evaluation, MemCell& cell, SubArray::ReadResult *result);
+BitPlane CopySubInput(const BitPlane &orginal, int positionRow, int positionVector, int numInputVector, int numRow);
+void GetInputVector(const BitPlane &input, int numInput, double *activityRowRead, vector<double> &copy);
+vector<double> GetCellConductance(const MatrixView &weight, MemCell& cell, const EvaluationState *evaluation=NULL, const CrossbarSolver *solver=NULL);
+void GetColumnResistance(const vector<double> &input, const vector<double> &cellConductance, int numRow, int numCol, MemCell& cell, bool parallelRead, double resCellAccess, 
+						vector<double> &columnG, vector<double> &resistance);
+void GetExpectedColumnResistance(const vector<double> &density, const vector<double> &cellConductance, int numRow, int numCol, MemCell& cell, bool parallelRead, 
+						double resCellAccess, vector<double> &columnG, vector<double> &resistance);
+void GetNoisyColumnResistance(const vector<double> &input, const vector<double> &cellConductance, const MatrixView &weight, uint64_t inputIndex, 
+						const EvaluationState &evaluation, MemCell& cell, bool parallelRead, double resCellAccess, vector<double> &columnG, vector<double> &variance, vector<double> &resistance);
 
 
 #endif /* PROCESSINGUNIT_H_ */
\ No newline at end of file
@@ -40,6 +40,8 @@
 #define SUBARRAY_H_
 
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include "typedef.h"
 #include "InputParameter.h"
 #include "Technology.h"
@@ -71,7 +73,7 @@ using namespace std;
 class SubArray: public FunctionUnit {
 public:
 	SubArray(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell);
-	virtual ~SubArray() {}
+	virtual ~SubArray();
 	InputParameter& inputParameter;
 	Technology& tech;
 	MemCell& cell;
@@ -82,6 +84,8 @@ public:
 	void CalculateArea();
 	void CalculateLatency(double _rampInput, const vector<double> &columnResistance);
 	void CalculatePower(const vector<double> &columnResistance);
+	void CalculateReadPerformance(double _rampInput, const vector<double> &columnResistance);
+	SubArray *Clone() const;
 
 	/* Properties */	
 	bool initialized;	   // Initialization flag
@@ -180,6 +184,18 @@ public:
 	ShiftAdd shiftAdd;
 	MultilevelSenseAmp multilevelSenseAmp;
 	MultilevelSAEncoder multilevelSAEncoder;	
+	
+	/* Result cache of CalculateReadPerformance, cleared whenever the subArray is (re)initialized or sized */
+	struct ReadResult {
+		double readLatency, readDynamicEnergy, leakage;
+		double readLatencyADC, readLatencyAccum, readLatencyOther;
+		double readDynamicEnergyADC, readDynamicEnergyAccum, readDynamicEnergyOther;
+	};
+	unordered_map<string, ReadResult> readCache;	// key: raw bytes of the per-vector inputs
+	bool readCacheEnabled;	// set per chunk from param->readResultCache, off: every call is computed
+	string readKey;	// lookup key, kept as a member so its storage is reused across input vectors
+	long long numReadCacheHit, numReadCacheMiss;
+	static long long totalReadCacheHit, totalReadCacheMiss;	// summed over all subArrays when they are destroyed
 };
 
 #endif /* SUBARRAY_H_ */
@@ -48,20 +48,45 @@
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
+#include "BitPlane.h"
+#include "MatrixView.h"
+#include "SubArray.h"
+#include "Buffer.h"
+#include "HTree.h"
+#include "AdderTree.h"
+#include "Sigmoid.h"
+#include "BitShifter.h"
+#include "ProcessingUnit.h"
 
 using namespace std;
 
+/*** Circuit modules of the Tile level (and the PEs inside), private to each thread ***/
+struct TileContext {
+	SubArray *subArrayInPE;
+	Buffer *inputBuffer;
+	Buffer *outputBuffer;
+	HTree *hTree;
+	AdderTree *accumulation;
+	Sigmoid *sigmoid;
+	BitShifter *reLu;
+	ProcessingUnitContext pe;
+};
+
 /*** Functions ***/
+TileContext TileSaveContext();
+void TileLoadContext(const TileContext &context);
+TileContext TileCloneContext(const TileContext &context);
+void TileFreeContext(TileContext &context);
 void TileInitialize(InputParameter& inputParameter, Technology& tech, MemCell& cell, double _numPE, double _peSize);
 vector<double> TileCalculateArea(double numPE, double peSize, double *height, double *width);
-void TileCalculatePerformance(const vector<vector<double> > &newMemory, const vector<vector<double> > &oldMemory, const vector<vector<double> > &inputVector, 
+void TileCalculatePerformance(const MatrixView &newMemory, const MatrixView &oldMemory, const BitPlane &inputVector, 
 			int novelMap, double numPE, double peSize, 
 			int speedUpRow, int speedUpCol, int weightMatrixRow, int weightMatrixCol, int numInVector, MemCell& cell, double *readLatency, double *readDynamicEnergy, double *leakage,
 			double *bufferLatency, double *bufferDynamicEnergy, double *icLatency, double *icDynamicEnergy,
-			double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther);
+			double *coreLatencyADC, double *coreLatencyAccum, double *coreLatencyOther, double *coreEnergyADC, double *coreEnergyAccum, double *coreEnergyOther,
+			const EvaluationState &evaluation);
 		
-vector<vector<double> > CopyPEArray(const vector<vector<double> > &orginal, int positionRow, int positionCol, int numRow, int numCol);
-vector<vector<double> > CopyPEInput(const vector<vector<double> > &orginal, int positionRow, int numInputVector, int numRow);
+BitPlane CopyPEInput(const BitPlane &orginal, int positionRow, int numInputVector, int numRow);
 	
 
 #endif /* TILE_H_ */
\ No newline at end of file
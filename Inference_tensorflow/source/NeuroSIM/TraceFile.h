@@ -0,0 +1,104 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+#ifndef TRACEFILE_H_
+#define TRACEFILE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/* Binary trace layout (all fields little-endian):
+   64-byte header followed by a dense row-major numRow x numCol matrix at dataOffset.
+   TRACE_INT8 traces hold a raw quantized feature map instead of the expanded input matrix: numRow channels of
+   height x width (numCol = height*width) two's complement activation codes, the sliding windows of the following
+   kernel/stride/padding and the bit-planes are generated by the simulator (see LoadInFeatureMap) */
+#define TRACE_MAGIC			"NSTR"
+#define TRACE_VERSION		1
+#define TRACE_HEADER_SIZE	64
+
+enum TraceDataType {
+	TRACE_FLOAT32 = 0,
+	TRACE_FLOAT64 = 1,
+	TRACE_UINT8 = 2,
+	TRACE_INT8 = 3
+};
+
+struct TraceHeader {
+	char magic[4];		/* "NSTR" */
+	uint32_t version;	/* TRACE_VERSION */
+	uint32_t dtype;		/* TraceDataType */
+	uint32_t bitWidth;	/* precision of the traced data (synapseBit for weights, numBitInput for inputs), 0 if unknown */
+	uint64_t numRow;
+	uint64_t numCol;
+	uint64_t dataOffset;	/* byte offset of the matrix from the start of the file */
+	uint32_t height, width, kernel, stride, padding;	/* TRACE_INT8 only, 0 otherwise */
+	char reserved[4];
+};
+
+class TraceFile {
+public:
+	TraceFile();
+	~TraceFile();
+
+	/* Functions */
+	bool Open(const std::string &filename);	/* Map the file, returns false if it is not a binary trace */
+	void Close();
+	static bool IsBinaryTrace(const std::string &filename);
+
+	/* Element access, no bounds checking */
+	double Value(uint64_t row, uint64_t col) const {
+		uint64_t idx = row*header.numCol + col;
+		switch (header.dtype) {
+			case TRACE_FLOAT32:	return ((const float *)data)[idx];
+			case TRACE_FLOAT64:	return ((const double *)data)[idx];
+			case TRACE_INT8:	return ((const int8_t *)data)[idx];
+			default:			return ((const uint8_t *)data)[idx];
+		}
+	}
+
+	/* Properties */
+	TraceHeader header;
+	const char *data;	/* start of the matrix inside the mapping */
+
+private:
+	void *mapping;
+	size_t mapSize;
+};
+
+#endif /* TRACEFILE_H_ */
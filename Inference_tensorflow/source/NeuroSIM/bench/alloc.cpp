@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+// Allocation count of the per-input-vector loop, built with "make bench":
+//
+//   bench/alloc
+//
+// counts the calls of operator new while the input vectors of a 128x128 eNVM subArray are read, with the
+// buffers of the loop declared for every input vector (as GetInputVector and GetColumnResistance returned
+// them before) and reused from a ProcessingUnitScratch, then over the evaluation of a whole conv layer
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <new>
+#include "../constant.h"
+#include "../formula.h"
+#include "../Param.h"
+#include "../Tile.h"
+#include "../Chip.h"
+#include "../ProcessingUnit.h"
+#include "../SubArray.h"
+#include "../NeuroSim.h"
+#include "../Definition.h"
+
+using namespace std;
+
+static long long numAllocation = 0;
+
+void *operator new(size_t size) {
+	__sync_fetch_and_add(&numAllocation, 1);
+	void *p = malloc(size ? size : 1);
+	if (!p) {
+		throw bad_alloc();
+	}
+	return p;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *p) throw() {
+	free(p);
+}
+
+void operator delete[](void *p) throw() {
+	free(p);
+}
+
+int main() {
+	
+	const int numRow = 128, numCol = 128, numVector = 1000;
+	cell.memCellType = Type::RRAM;
+	gen.seed(0);
+	uniform_real_distribution<double> conductance(param->minConductance, param->maxConductance);
+	
+	vector<double> cellConductance((size_t) numRow*numCol);
+	for (size_t i=0; i<cellConductance.size(); i++) {
+		cellConductance[i] = conductance(gen);
+	}
+	BitPlane input;
+	input.Initialize(numRow, numVector);
+	for (int v=0; v<numVector; v++) {
+		for (int i=0; i<numRow; i++) {
+			if (gen() % 2) {
+				input.SetBit(i, v);
+			}
+		}
+	}
+	
+	double activityRowRead, sum = 0;
+	long long start = numAllocation;
+	for (int v=0; v<numVector; v++) {
+		vector<double> inputVector, columnG, columnResistance;
+		GetInputVector(input, v, &activityRowRead, inputVector);
+		GetColumnResistance(inputVector, cellConductance, numRow, numCol, cell, true, 0, columnG, columnResistance);
+		sum += columnResistance[v % numCol];
+	}
+	long long perVector = numAllocation - start;
+	
+	ProcessingUnitScratch buffer;
+	start = numAllocation;
+	for (int v=0; v<numVector; v++) {
+		GetInputVector(input, v, &activityRowRead, buffer.input);
+		GetColumnResistance(buffer.input, cellConductance, numRow, numCol, cell, true, 0, buffer.columnG, buffer.columnResistance);
+		sum += buffer.columnResistance[v % numCol];
+	}
+	long long reused = numAllocation - start;
+	cout << numVector << " input vectors of a " << numRow << "x" << numCol << " subArray (checksum " << sum << "): " << perVector 
+		 << " allocations with buffers per input vector, " << reused << " with a ProcessingUnitScratch" << endl;
+	
+	// one 3x3 conv layer of 64 to 64 channels on an 8x8 feature map, 36 input vectors of 8 bits
+	vector<vector<double> > netStructure(1, vector<double>(7, 0));
+	netStructure[0][0] = netStructure[0][1] = 8;
+	netStructure[0][2] = netStructure[0][5] = 64;
+	netStructure[0][3] = netStructure[0][4] = 3;
+	int weightRow = 64*3*3, weightCol = 64, inputCol = 36*8;
+	vector<double> weightData((size_t) weightRow*weightCol);
+	vector<unsigned char> inputData((size_t) weightRow*inputCol);
+	uniform_real_distribution<double> weightValue(-1, 1);
+	for (size_t i=0; i<weightData.size(); i++) {
+		weightData[i] = weightValue(gen);
+	}
+	for (size_t i=0; i<inputData.size(); i++) {
+		inputData[i] = gen() % 2;
+	}
+	
+	ChipDesign design;
+	NeuroSimFloorPlan(netStructure, 8, 8, &design);
+	NeuroSimInitialize(&design);
+	WeightMatrix weight = LoadInWeightArray(&weightData[0], weightRow, weightCol, param->numRowPerSynapse, param->numColPerSynapse, param->maxConductance, param->minConductance);
+	BitPlane layerInput = LoadInInputArray(&inputData[0], weightRow, inputCol);
+	LayerPerformance result;
+	start = numAllocation;
+	NeuroSimCalculateLayer(design, 0, weight, layerInput, &result);
+	cout << "Conv layer " << weightRow << "x" << weightCol << " with " << inputCol << " input columns: " << numAllocation - start << " allocations" << endl;
+	NeuroSimFree(&design);
+	
+	return 0;
+}
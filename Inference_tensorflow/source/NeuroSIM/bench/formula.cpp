@@ -0,0 +1,141 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+// Microbenchmark of the formula helpers, built with "make bench":
+//
+//   bench/formula [NetWork.csv]
+//
+// times the helpers of formula.h called with the Technology by const reference against the same calls through
+// wrappers that take it by value (the copy every call made before), and the floorplan and initialization of the
+// chip (NeuroSimFloorPlan + NeuroSimInitialize, 8-bit weights and inputs) that these helpers dominate
+
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "../constant.h"
+#include "../formula.h"
+#include "../Param.h"
+#include "../Tile.h"
+#include "../Chip.h"
+#include "../ProcessingUnit.h"
+#include "../SubArray.h"
+#include "../NeuroSim.h"
+#include "../Definition.h"
+
+using namespace std;
+
+// the helpers as they were called before, with a copy of the Technology
+static double GateCapByValue(double width, Technology tech) {
+	return CalculateGateCap(width, tech);
+}
+
+static double GateAreaByValue(int gateType, int numInput, double widthNMOS, double widthPMOS, double heightTransistorRegion, Technology tech, double *height, double *width) {
+	return CalculateGateArea(gateType, numInput, widthNMOS, widthPMOS, heightTransistorRegion, tech, height, width);
+}
+
+static double GateLeakageByValue(int gateType, int numInput, double widthNMOS, double widthPMOS, double temperature, Technology tech) {
+	return CalculateGateLeakage(gateType, numInput, widthNMOS, widthPMOS, temperature, tech);
+}
+
+static double OnResistanceByValue(double width, int type, double temperature, Technology tech) {
+	return CalculateOnResistance(width, type, temperature, tech);
+}
+
+static double PassGateAreaByValue(double widthNMOS, double widthPMOS, Technology tech, int numFold, double *height, double *width) {
+	return CalculatePassGateArea(widthNMOS, widthPMOS, tech, numFold, height, width);
+}
+
+int main(int argc, char * argv[]) {
+	
+	const char *network = argc > 1 ? argv[1] : "NetWork.csv";
+	const int numCall = 2000000;
+	const int numInit = 5;
+	
+	Technology technology;
+	technology.Initialize(param->technode, HP, conventional);	// the defaults of Param.cpp
+	double width = param->technode*1e-9;
+	double height, widthGate, sum;
+	
+	sum = 0;
+	auto start = chrono::high_resolution_clock::now();
+	for (int i=0; i<numCall; i++) {
+		double w = width*(1 + (i & 15));
+		sum += GateCapByValue(w, technology) + OnResistanceByValue(w, NMOS, 300, technology) + GateLeakageByValue(INV, 1, w, 2*w, 300, technology)
+			+ GateAreaByValue(NAND, 2, w, 2*w, 40*width, technology, &height, &widthGate) + PassGateAreaByValue(w, 2*w, technology, 1, &height, &widthGate);
+	}
+	auto end = chrono::high_resolution_clock::now();
+	double byValue = chrono::duration<double>(end-start).count();
+	double checkByValue = sum;
+	
+	sum = 0;
+	start = chrono::high_resolution_clock::now();
+	for (int i=0; i<numCall; i++) {
+		double w = width*(1 + (i & 15));
+		sum += CalculateGateCap(w, technology) + CalculateOnResistance(w, NMOS, 300, technology) + CalculateGateLeakage(INV, 1, w, 2*w, 300, technology)
+			+ CalculateGateArea(NAND, 2, w, 2*w, 40*width, technology, &height, &widthGate) + CalculatePassGateArea(w, 2*w, technology, 1, &height, &widthGate);
+	}
+	end = chrono::high_resolution_clock::now();
+	double byReference = chrono::duration<double>(end-start).count();
+	
+	if (sum != checkByValue) {
+		cerr << "Error: the helpers do not give the same results by value and by reference!" << endl;
+		return -1;
+	}
+	cout << "Technology is " << sizeof(Technology) << " bytes" << endl;
+	cout << numCall << " x 5 helper calls, Technology by value: " << byValue << " s, by const reference: " << byReference << " s" << endl;
+	
+	vector<vector<double> > netStructure = getNetStructure(network);
+	double initTime = 0;
+	for (int i=0; i<numInit; i++) {
+		ChipDesign design;
+		tech.initialized = false;	// initialized again by every floorplan
+		start = chrono::high_resolution_clock::now();
+		NeuroSimFloorPlan(netStructure, 8, 8, &design);
+		NeuroSimInitialize(&design);
+		end = chrono::high_resolution_clock::now();
+		initTime += chrono::duration<double>(end-start).count();
+		NeuroSimFree(&design);
+	}
+	cout << "Floorplan and initialization of " << network << ": " << initTime/numInit*1e3 << " ms (average of " << numInit << ")" << endl;
+	
+	return 0;
+}
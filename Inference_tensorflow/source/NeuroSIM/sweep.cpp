@@ -0,0 +1,415 @@
+/*******************************************************************************
+* Copyright (c) 2015-2017
+* School of Electrical, Computer and Energy Engineering, Arizona State University
+* PI: Prof. Shimeng Yu
+* All rights reserved.
+* 
+* This source code is part of NeuroSim - a device-circuit-algorithm framework to benchmark 
+* neuro-inspired architectures with synaptic devices(e.g., SRAM and emerging non-volatile memory). 
+* Copyright of the model is maintained by the developers, and the model is distributed under 
+* the terms of the Creative Commons Attribution-NonCommercial 4.0 International Public License 
+* http://creativecommons.org/licenses/by-nc/4.0/legalcode.
+* The source code is free and you can redistribute and/or modify it
+* by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Developer list: 
+*   Pai-Yu Chen	    Email: pchen72 at asu dot edu 
+*                    
+*   Xiaochen Peng   Email: xpeng15 at asu dot edu
+********************************************************************************/
+
+// Design-space sweep: evaluate one network at many Param settings and write one row per setting
+//
+//   ./sweep [--config file.ini] [--set name=value] NetWork.csv synapseBit numBitInput sweep.txt result.csv numJob weight1.csv input1.csv ...
+//
+// sweep.txt either gives a grid, one parameter per line (every combination is evaluated, the last line varies fastest)
+//     numRowSubArray = 64, 128, 256
+//     numColMuxed = 8, 16
+// or a list of points, a header with the parameter names followed by one line per point
+//     numRowSubArray, levelOutput, technode
+//     128, 16, 22
+//     256, 32, 14
+//     128, 16, 7
+// Names are the fields of Param (see Param::SetValue), the fields not named keep their value of Param.cpp (or of --config/--set), '#' starts a comment.
+// numJob points are evaluated at the same time (0: one per core).
+//
+// param, tech and cell are process-wide, so every point runs in its own child process that starts from a copy of the sweep
+// state. What does not depend on the point is done once in the parent and inherited: the input traces are read once, the
+// weights are converted to cell codes once per cellBit (only the conductance table follows the point) and the floorplan is
+// found once per (novelMapping, numRowSubArray, numColSubArray, cellBit, floorPlanSearch, floorPlanMetric); the remaining
+// stages (ChipInitialize, ChipCalculateArea and the layers) depend on the circuit parameters and run in the child.
+
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdlib.h>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <omp.h>
+#include "constant.h"
+#include "formula.h"
+#include "Param.h"
+#include "Tile.h"
+#include "Chip.h"
+#include "ProcessingUnit.h"
+#include "SubArray.h"
+#include "NeuroSim.h"
+#include "Definition.h"
+
+using namespace std;
+
+vector<string> SplitSweepLine(const string &line, char delimiter);
+void LoadSweepFile(const string &sweepfile, vector<string> *names, vector<vector<double> > *points);
+string EvaluateSweepPoint(const ChipDesign &floorPlan, const vector<WeightMatrix> &weight, const vector<BitPlane> &input);
+
+int main(int argc, char * argv[]) {   
+
+	auto start = chrono::high_resolution_clock::now();
+	
+	// --config file.ini / --set name=value give the values the points start from
+	param->ParseArguments(&argc, argv);
+	
+	if (argc < 7) {
+		cerr << "Usage: " << argv[0] << " NetWork.csv synapseBit numBitInput sweep.txt result.csv numJob weight1.csv input1.csv ..." << endl;
+		exit(1);
+	}
+	
+	vector<vector<double> > netStructure;
+	netStructure = getNetStructure(argv[1]);
+	int synapseBit = atoi(argv[2]);
+	int numBitInput = atoi(argv[3]);
+	int numLayer = netStructure.size();
+	if (argc < 7 + 2*numLayer) {
+		cerr << "Error: the network has " << numLayer << " layers but only " << (argc-7)/2 << " weight/input pairs are given!" << endl;
+		exit(1);
+	}
+	
+	vector<string> names;
+	vector<vector<double> > points;
+	LoadSweepFile(argv[4], &names, &points);
+	int numPoint = points.size();
+	
+	int numJob = atoi(argv[6]);
+	int numProc = omp_get_num_procs();
+	if (numJob <= 0) {
+		numJob = numProc;
+	}
+	numJob = min(numJob, max(numPoint, 1));
+	int numThreadPerJob = max(numProc/numJob, 1);
+	
+	// the input traces do not depend on the point
+	vector<BitPlane> input(numLayer);
+	for (int i=0; i<numLayer; i++) {
+		input[i] = LoadInInputData(argv[2*i+8]);
+	}
+	
+	Param baseParam = *param;
+	map<vector<double>, ChipDesign> floorPlanCache;
+	map<vector<double>, vector<WeightMatrix> > weightCache;
+	
+	vector<string> result(numPoint);
+	vector<int> pipeOfJob;
+	vector<pid_t> pidOfJob;
+	vector<int> pointOfJob;
+	int numDone = 0;
+	
+	cout << "------------------------------ Design-Space Sweep --------------------------------" <<  endl;
+	cout << numPoint << " points, " << numJob << " at a time" << endl;
+	
+	for (int p=0; p<=numPoint; p++) {
+		
+		// wait for a slot (or for everyone after the last point)
+		while (pidOfJob.size() >= numJob || (p == numPoint && !pidOfJob.empty())) {
+			int status;
+			pid_t pid = wait(&status);
+			int j = find(pidOfJob.begin(), pidOfJob.end(), pid) - pidOfJob.begin();
+			if (j == pidOfJob.size()) {
+				continue;
+			}
+			string row;
+			char buf[4096];
+			ssize_t len;
+			while ((len = read(pipeOfJob[j], buf, sizeof(buf))) > 0) {
+				row.append(buf, len);
+			}
+			close(pipeOfJob[j]);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || row.empty()) {
+				cerr << "Error: point " << pointOfJob[j]+1 << " of the sweep failed!" << endl;
+			}
+			result[pointOfJob[j]] = row;
+			numDone++;
+			cout << "point " << pointOfJob[j]+1 << " done (" << numDone << "/" << numPoint << ")" << endl;
+			
+			pipeOfJob.erase(pipeOfJob.begin()+j);
+			pidOfJob.erase(pidOfJob.begin()+j);
+			pointOfJob.erase(pointOfJob.begin()+j);
+		}
+		if (p == numPoint) {
+			break;
+		}
+		
+		*param = baseParam;
+		for (int n=0; n<names.size(); n++) {
+			param->SetValue(names[n], points[p][n]);
+		}
+		param->Update();
+		
+		// find (or reuse) the floorplan, NeuroSimFloorPlan also derives the precision kept in param
+		vector<double> floorPlanKey;
+		floorPlanKey.push_back(param->novelMapping);
+		floorPlanKey.push_back(param->numRowSubArray);
+		floorPlanKey.push_back(param->numColSubArray);
+		floorPlanKey.push_back(param->cellBit);
+		floorPlanKey.push_back(param->floorPlanSearch);
+		floorPlanKey.push_back(param->floorPlanMetric);
+		if (floorPlanCache.find(floorPlanKey) == floorPlanCache.end()) {
+			NeuroSimFloorPlan(netStructure, synapseBit, numBitInput, &floorPlanCache[floorPlanKey]);
+		}
+		const ChipDesign &floorPlan = floorPlanCache[floorPlanKey];
+		NeuroSimLoadPrecision(floorPlan);
+		
+		vector<double> weightKey;
+		weightKey.push_back(param->cellBit);
+		weightKey.push_back(param->numColPerSynapse);
+		if (weightCache.find(weightKey) == weightCache.end()) {
+			vector<WeightMatrix> &weight = weightCache[weightKey];
+			weight.resize(numLayer);
+			for (int i=0; i<numLayer; i++) {
+				weight[i] = LoadInWeightData(argv[2*i+7], param->numRowPerSynapse, param->numColPerSynapse, param->maxConductance, param->minConductance);
+			}
+		}
+		vector<WeightMatrix> &weight = weightCache[weightKey];
+		for (int i=0; i<numLayer; i++) {
+			weight[i].SetConductanceRange(param->cellBit, param->maxConductance, param->minConductance);	// the child inherits the table of its point
+		}
+		
+		int fd[2];
+		if (pipe(fd) != 0) {
+			cerr << "Error: cannot create the pipe for point " << p+1 << "!" << endl;
+			exit(1);
+		}
+		cout.flush();
+		pid_t pid = fork();
+		if (pid < 0) {
+			cerr << "Error: cannot start the process for point " << p+1 << "!" << endl;
+			exit(1);
+		}
+		if (pid == 0) {
+			// child: the modules only print warnings, keep the sweep log readable
+			close(fd[0]);
+			int devNull = open("/dev/null", O_WRONLY);
+			dup2(devNull, STDOUT_FILENO);
+			close(devNull);
+			omp_set_num_threads(numThreadPerJob);
+			gen.seed(0);
+			
+			string row = EvaluateSweepPoint(floorPlan, weight, input);
+			if (write(fd[1], row.data(), row.size()) != row.size()) {
+				_exit(1);
+			}
+			close(fd[1]);
+			_exit(0);
+		}
+		close(fd[1]);
+		pipeOfJob.push_back(fd[0]);
+		pidOfJob.push_back(pid);
+		pointOfJob.push_back(p);
+	}
+	
+	ofstream outfile(argv[5]);
+	if (!outfile.good()) {
+		cerr << "Error: the result file cannot be opened!" << endl;
+		exit(1);
+	}
+	outfile << "point";
+	for (int n=0; n<names.size(); n++) {
+		outfile << "," << names[n];
+	}
+	outfile << ",chipArea(um^2),chipAreaIC(um^2),chipAreaADC(um^2),chipAreaAccum(um^2),chipAreaOther(um^2)"
+			<< ",readLatency(ns),readDynamicEnergy(pJ),leakageEnergy(pJ),leakagePower(uW)"
+			<< ",bufferLatency(ns),bufferReadDynamicEnergy(pJ),icLatency(ns),icReadDynamicEnergy(pJ)"
+			<< ",latencyADC(ns),latencyAccum(ns),latencyOther(ns),energyADC(pJ),energyAccum(pJ),energyOther(pJ)"
+			<< ",TOPS/W,FPS" << endl;
+	for (int p=0; p<numPoint; p++) {
+		outfile << p+1;
+		for (int n=0; n<names.size(); n++) {
+			outfile << "," << points[p][n];
+		}
+		outfile << result[p] << endl;
+	}
+	outfile.close();
+	
+	auto stop = chrono::high_resolution_clock::now();
+	auto duration = chrono::duration_cast<chrono::seconds>(stop-start);
+	cout << "Results of " << numPoint << " points written to " << argv[5] << endl;
+	cout << "Floorplans found: " << floorPlanCache.size() << ", weight conversions: " << weightCache.size() << endl;
+	cout << "Total Run-time of the sweep: " << duration.count() << " seconds" << endl;
+	cout << "------------------------------ Design-Space Sweep --------------------------------" <<  endl;
+	
+	return 0;
+}
+
+
+// initialize the chip of the current param on the floorplan and evaluate all layers, returns the metrics as ",v1,v2,..."
+string EvaluateSweepPoint(const ChipDesign &floorPlan, const vector<WeightMatrix> &weight, const vector<BitPlane> &input) {
+	
+	ChipDesign design = floorPlan;
+	NeuroSimInitialize(&design);
+	ChipPerformance performance = NeuroSimCalculatePerformance(design, weight, input);
+	
+	// same units as the report of main
+	ostringstream row;
+	for (int i=0; i<5; i++) {
+		row << "," << design.chipAreaResults[i]*1e12;
+	}
+	row << "," << performance.readLatency*1e9 << "," << performance.readDynamicEnergy*1e12
+		<< "," << performance.leakageEnergy*1e12 << "," << performance.leakage*1e6;
+	row << "," << performance.bufferLatency*1e9 << "," << performance.bufferDynamicEnergy*1e12
+		<< "," << performance.icLatency*1e9 << "," << performance.icDynamicEnergy*1e12;
+	row << "," << performance.latencyADC*1e9 << "," << performance.latencyAccum*1e9 << "," << performance.latencyOther*1e9
+		<< "," << performance.energyADC*1e12 << "," << performance.energyAccum*1e12 << "," << performance.energyOther*1e12;
+	row << "," << performance.numComputation/(performance.readDynamicEnergy*1e12+performance.leakageEnergy*1e12)
+		<< "," << 1/(performance.readLatency);
+	
+	NeuroSimFree(&design);
+	return row.str();
+}
+
+
+vector<string> SplitSweepLine(const string &line, char delimiter) {
+	vector<string> fields;
+	istringstream iss(line);
+	string field;
+	while (getline(iss, field, delimiter)) {
+		field.erase(0, field.find_first_not_of(" \t\r"));
+		field.erase(field.find_last_not_of(" \t\r")+1);
+		if (!field.empty()) {
+			fields.push_back(field);
+		}
+	}
+	return fields;
+}
+
+
+void LoadSweepFile(const string &sweepfile, vector<string> *names, vector<vector<double> > *points) {
+	ifstream infile(sweepfile.c_str());
+	if (!infile.good()) {
+		cerr << "Error: the sweep file cannot be opened!" << endl;
+		exit(1);
+	}
+	
+	vector<vector<string> > lines;
+	bool grid = false;
+	string inputline;
+	while (getline(infile, inputline, '\n')) {
+		inputline = inputline.substr(0, inputline.find('#'));
+		if (inputline.find_first_not_of(" \t\r") == string::npos) {
+			continue;
+		}
+		if (lines.empty()) {
+			grid = (inputline.find('=') != string::npos);
+		}
+		if (grid) {
+			size_t eq = inputline.find('=');
+			if (eq == string::npos) {
+				cerr << "Error: missing '=' in the sweep file: " << inputline << endl;
+				exit(1);
+			}
+			vector<string> line = SplitSweepLine(inputline.substr(0, eq), ',');
+			vector<string> values = SplitSweepLine(inputline.substr(eq+1), ',');
+			if (line.size() != 1 || values.empty()) {
+				cerr << "Error: expected 'name = value, value, ...' in the sweep file: " << inputline << endl;
+				exit(1);
+			}
+			line.insert(line.end(), values.begin(), values.end());
+			lines.push_back(line);
+		} else {
+			lines.push_back(SplitSweepLine(inputline, ','));
+		}
+	}
+	infile.close();
+	if (lines.empty()) {
+		cerr << "Error: the sweep file is empty!" << endl;
+		exit(1);
+	}
+	
+	vector<vector<double> > values;
+	if (grid) {
+		for (int i=0; i<lines.size(); i++) {
+			names->push_back(lines[i][0]);
+			vector<double> value;
+			for (int j=1; j<lines[i].size(); j++) {
+				value.push_back(atof(lines[i][j].c_str()));
+			}
+			values.push_back(value);
+		}
+		// every combination, the last parameter varies fastest
+		points->assign(1, vector<double>());
+		for (int i=0; i<values.size(); i++) {
+			vector<vector<double> > expanded;
+			for (int p=0; p<points->size(); p++) {
+				for (int j=0; j<values[i].size(); j++) {
+					expanded.push_back((*points)[p]);
+					expanded.back().push_back(values[i][j]);
+				}
+			}
+			points->swap(expanded);
+		}
+	} else {
+		*names = lines[0];
+		for (int i=1; i<lines.size(); i++) {
+			if (lines[i].size() != names->size()) {
+				cerr << "Error: point " << i << " of the sweep file has " << lines[i].size() << " values for " << names->size() << " parameters!" << endl;
+				exit(1);
+			}
+			vector<double> point;
+			for (int j=0; j<lines[i].size(); j++) {
+				point.push_back(atof(lines[i][j].c_str()));
+			}
+			points->push_back(point);
+		}
+	}
+	
+	Param check;
+	for (int n=0; n<names->size(); n++) {
+		if (!check.HasField((*names)[n])) {
+			cerr << "Error: unknown parameter '" << (*names)[n] << "' in the sweep file!" << endl;
+			exit(1);
+		}
+	}
+	for (int p=0; p<points->size(); p++) {
+		for (int n=0; n<names->size(); n++) {
+			if (!check.SetValue((*names)[n], (*points)[p][n])) {
+				cerr << "Error: at point " << p+1 << " of the sweep file" << endl;
+				exit(1);
+			}
+		}
+	}
+}
@@ -23,6 +23,8 @@ bitsE = 8  # bit width of errors
 
 bitsR = 16  # bit width of randomizer
 
+traceFormat = 'csv'  # format of the layer traces passed to NeuroSIM: 'csv', 'bin' or 'lib' (in-process, needs "make python" in NeuroSIM)
+
 lr = tf.Variable(initial_value=0., trainable=False, name='lr', dtype=tf.float32)
 lr_schedule = [0, 8, 200, 1,250,1./8,300,0]
 
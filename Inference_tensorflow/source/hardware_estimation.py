@@ -1,7 +1,16 @@
 import os
+import struct
 import numpy as np
 from subprocess import call
-def hardware_estimation(IN, W, weight_length, input_length ):
+# binary trace format read by NeuroSIM/TraceFile.cpp
+TRACE_MAGIC = b'NSTR'
+TRACE_VERSION = 1
+TRACE_HEADER_SIZE = 64
+TRACE_DTYPE = {np.dtype(np.float32): 0, np.dtype(np.float64): 1, np.dtype(np.uint8): 2, np.dtype(np.int8): 3}
+
+def hardware_estimation(IN, W, weight_length, input_length, trace_format='csv'):
+    if trace_format == 'lib':
+        return neurosim_estimation(IN, W, weight_length, input_length)
     if not os.path.exists('./layer_record'):
         os.makedirs('./layer_record')
     output_path = './layer_record/'
@@ -10,36 +19,99 @@ def hardware_estimation(IN, W, weight_length, input_length ):
     f = open('./layer_record/trace_command.sh', "w")
     f.write('./NeuroSIM/main ./NeuroSIM/NetWork.csv '+str(weight_length)+' '+str(input_length)+' ')
     for i,(input,weight) in enumerate(zip(IN,W)):
-        input_file_name = 'input_layer' + str(i) + '.csv'
-        weight_file_name = 'weight_layer' + str(i) + '.csv'
+        ext = '.bin' if trace_format == 'bin' else '.csv'
+        input_file_name = 'input_layer' + str(i) + ext
+        weight_file_name = 'weight_layer' + str(i) + ext
         f.write(output_path + weight_file_name+' '+output_path + input_file_name+' ')
-        write_matrix_weight(weight, output_path + weight_file_name)
+        write_matrix_weight(weight, output_path + weight_file_name, trace_format, weight_length)
         if len(weight.shape) > 2:
             k = weight.shape[0]
-            write_matrix_activation_conv(stretch_input(input, k), None, input_length, output_path + input_file_name)
+            if trace_format == 'bin' and input_length <= 8:
+                write_feature_map(input, k, input_length, output_path + input_file_name)
+            else:
+                write_matrix_activation_conv(stretch_input(input, k), None, input_length, output_path + input_file_name, trace_format)
         else:
-            write_matrix_activation_fc(input, None, input_length, output_path + input_file_name)
+            write_matrix_activation_fc(input, None, input_length, output_path + input_file_name, trace_format)
     f.close()
     call(["/bin/bash", "./layer_record/trace_command.sh"])
-def write_matrix_weight(input_matrix, filename):
+
+def neurosim_estimation(IN, W, weight_length, input_length, chip=None):
+    # in-process NeuroSIM (build it with "make python" in ./NeuroSIM), the chip can be passed back in to skip the initialization
+    import sys
+    sys.path.insert(0, './NeuroSIM')
+    import neurosim
+    weights, inputs = [], []
+    for input, weight in zip(IN, W):
+        weights.append(weight_matrix(weight))
+        if len(weight.shape) > 2:
+            k = weight.shape[0]
+            if input_length <= 8:
+                inputs.append((feature_map(input, input_length), k, 1, 0))
+            else:
+                inputs.append(activation_matrix_conv(stretch_input(input, k), input_length))
+        else:
+            inputs.append(activation_matrix_fc(input, input_length))
+    if chip is None:
+        chip = neurosim.Chip('./NeuroSIM/NetWork.csv', int(weight_length), int(input_length))
+    result = chip.evaluate(weights, inputs)
+    chip.report(result)
+    return chip, result
+def write_trace(matrix, filename, bit_width=0, geometry=(0, 0, 0, 0, 0)):
+    # geometry: height, width, kernel, stride, padding of an int8 feature map trace
+    matrix = np.ascontiguousarray(matrix, dtype=matrix.dtype.newbyteorder('<'))
+    header = struct.pack('<4sIIIQQQIIIII4x', TRACE_MAGIC, TRACE_VERSION, TRACE_DTYPE[matrix.dtype.newbyteorder('=')],
+                         int(bit_width), matrix.shape[0], matrix.shape[1], TRACE_HEADER_SIZE, *geometry)
+    with open(filename, 'wb') as f:
+        f.write(header)
+        matrix.tofile(f)
+
+def weight_matrix(input_matrix):
     cout = input_matrix.shape[-1]
-    weight_matrix = input_matrix.reshape(-1, cout)
-    np.savetxt(filename, weight_matrix, delimiter=",", fmt='%10.5f')
+    return input_matrix.reshape(-1, cout)
+
+def write_matrix_weight(input_matrix, filename, trace_format='csv', bit_width=0):
+    if trace_format == 'bin':
+        write_trace(weight_matrix(input_matrix).astype(np.float32), filename, bit_width)
+    else:
+        np.savetxt(filename, weight_matrix(input_matrix), delimiter=",", fmt='%10.5f')
+
+def feature_map(input_matrix, length):
+    # activation codes of the first image (C x H x W), two's complement of the bits dec2bin produces
+    delta = 1.0 / (2 ** (length - 1))
+    codes = np.floor(input_matrix[0] / delta)
+    return np.clip(codes, -2 ** (length - 1), 2 ** (length - 1) - 1).astype(np.int8)
 
-def write_matrix_activation_conv(input_matrix, fill_dimension, length, filename):
-    filled_matrix_b = np.zeros([input_matrix.shape[2], input_matrix.shape[1] * length], dtype=np.str)
+def write_feature_map(input_matrix, kernel, length, filename, stride=1, padding=0):
+    # raw feature map instead of the stretched bit matrix, NeuroSIM generates the windows and bit-planes itself
+    fmap = feature_map(input_matrix, length)
+    c, h, w = fmap.shape
+    write_trace(fmap.reshape(c, h * w), filename, length, (h, w, kernel, stride, padding))
+
+def activation_matrix_conv(input_matrix, length, dtype=np.uint8):
+    filled_matrix_b = np.zeros([input_matrix.shape[2], input_matrix.shape[1] * length], dtype=dtype)
     filled_matrix_bin, scale = dec2bin(input_matrix[0, :], length)
     for i, b in enumerate(filled_matrix_bin):
         filled_matrix_b[:, i::length] = b.transpose()
-    np.savetxt(filename, filled_matrix_b, delimiter=",", fmt='%s')
+    return filled_matrix_b
 
-def write_matrix_activation_fc(input_matrix, fill_dimension, length, filename):
+def write_matrix_activation_conv(input_matrix, fill_dimension, length, filename, trace_format='csv'):
+    if trace_format == 'bin':
+        write_trace(activation_matrix_conv(input_matrix, length), filename, length)
+    else:
+        np.savetxt(filename, activation_matrix_conv(input_matrix, length, np.str), delimiter=",", fmt='%s')
 
-    filled_matrix_b = np.zeros([input_matrix.shape[1], length], dtype=np.str)
+def activation_matrix_fc(input_matrix, length, dtype=np.uint8):
+    filled_matrix_b = np.zeros([input_matrix.shape[1], length], dtype=dtype)
     filled_matrix_bin, scale = dec2bin(input_matrix[0, :], length)
     for i, b in enumerate(filled_matrix_bin):
         filled_matrix_b[:, i] = b
-    np.savetxt(filename, filled_matrix_b, delimiter=",", fmt='%s')
+    return filled_matrix_b
+
+def write_matrix_activation_fc(input_matrix, fill_dimension, length, filename, trace_format='csv'):
+    if trace_format == 'bin':
+        write_trace(activation_matrix_fc(input_matrix, length), filename, length)
+    else:
+        np.savetxt(filename, activation_matrix_fc(input_matrix, length, np.str), delimiter=",", fmt='%s')
 
 
 